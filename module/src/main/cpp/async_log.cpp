@@ -0,0 +1,210 @@
+#include "async_log.h"
+#include <android/log.h>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "log.h"
+
+namespace AsyncLog {
+    namespace {
+        constexpr uint32_t kRingRecords = 64;   // 2 的幂
+        constexpr size_t kRecordSize = 256;
+        // 一次 __android_log_write 的正文上限，低于 logd 单条负载上限（约 4 KB）
+        constexpr size_t kBatchSize = 4000;
+
+        static_assert((kRingRecords & (kRingRecords - 1)) == 0);
+
+        struct Record {
+            uint8_t prio;
+            char text[kRecordSize - 1];
+        };
+
+        // 单生产者（拥有它的线程）单消费者（写出线程）
+        struct Ring {
+            alignas(64) std::atomic<uint32_t> head{0};
+            alignas(64) std::atomic<uint32_t> tail{0};
+            std::atomic<bool> owned{true};
+            Ring *next = nullptr;
+            Record records[kRingRecords];
+        };
+
+        // 只增不减的链表：线程退出后环形缓冲区交还，由新线程复用
+        std::atomic<Ring *> rings{nullptr};
+        std::atomic<bool> started{false};
+        std::atomic<uint64_t> dropped{0};
+        // 保证同一时刻只有一个消费者
+        std::atomic_flag draining = ATOMIC_FLAG_INIT;
+        // 写出线程在 wakeups 上 futex 等待；idle 表示它可能正在等待，写者只在此时发起系统调用
+        std::atomic<uint32_t> wakeups{0};
+        std::atomic<bool> idle{false};
+        pthread_key_t ringKey;
+
+        Ring *AcquireRing() {
+            for (Ring *r = rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+                bool expected = false;
+                if (!r->owned.load(std::memory_order_relaxed) &&
+                    r->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return r;
+                }
+            }
+            Ring *r = new (std::nothrow) Ring;
+            if (r == nullptr) return nullptr;
+            r->next = rings.load(std::memory_order_relaxed);
+            while (!rings.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+            return r;
+        }
+
+        // 每个写过日志的线程持有一个环形缓冲区（平凡类型的 thread_local 没有析构注册），
+        // 线程退出时由 ringKey 的析构函数释放所有权
+        thread_local Ring *t_ring = nullptr;
+
+        void ReleaseRing(void *ring) {
+            static_cast<Ring *>(ring)->owned.store(false, std::memory_order_release);
+        }
+
+        bool AnyPending() {
+            for (Ring *r = rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+                if (r->head.load(std::memory_order_relaxed) != r->tail.load(std::memory_order_relaxed)) return true;
+            }
+            return false;
+        }
+
+        // 同一优先级的连续记录以换行拼成一条写给 logd（logcat 仍按行显示），减少 socket 写次数
+        struct Batch {
+            int prio = 0;
+            size_t len = 0;
+            char text[kBatchSize];
+
+            void Flush() {
+                if (len == 0) return;
+                text[len] = '\0';
+                __android_log_write(prio, LOG_TAG, text);
+                len = 0;
+            }
+
+            void Add(const Record &rec) {
+                size_t n = strnlen(rec.text, sizeof(rec.text));
+                if (len > 0 && (rec.prio != prio || len + 1 + n >= sizeof(text))) Flush();
+                if (len > 0) text[len++] = '\n';
+                prio = rec.prio;
+                memcpy(text + len, rec.text, n);
+                len += n;
+            }
+        };
+
+        size_t DrainAll() {
+            while (draining.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+            static Batch batch;  // 受 draining 保护
+            size_t count = 0;
+            for (Ring *r = rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+                uint32_t tail = r->tail.load(std::memory_order_relaxed);
+                uint32_t head = r->head.load(std::memory_order_acquire);
+                for (; tail != head; tail++, count++) batch.Add(r->records[tail & (kRingRecords - 1)]);
+                batch.Flush();
+                r->tail.store(tail, std::memory_order_release);
+            }
+            draining.clear(std::memory_order_release);
+            return count;
+        }
+
+        void Wake() {
+            wakeups.fetch_add(1, std::memory_order_release);
+            syscall(__NR_futex, &wakeups, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+
+        // 有日志时一轮写完所有缓冲区，全部为空时阻塞到写者唤醒；丢弃计数变化时补一条警告
+        void DrainLoop() {
+            prctl(PR_SET_NAME, "randomid-log");
+            setpriority(PRIO_PROCESS, 0, 19);
+            uint64_t reported = 0;
+            for (;;) {
+                uint32_t seen = wakeups.load(std::memory_order_acquire);
+                size_t count = DrainAll();
+                uint64_t lost = dropped.load(std::memory_order_relaxed);
+                if (lost != reported) {
+                    __android_log_print(ANDROID_LOG_WARN, LOG_TAG, "Async log dropped %llu records",
+                                        (unsigned long long) (lost - reported));
+                    reported = lost;
+                }
+                if (count != 0) continue;
+
+                // 与 Write 的 head 发布 / idle 读取配对：要么写者看到 idle 并唤醒，要么这里看到新记录
+                idle.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!AnyPending()) {
+                    syscall(__NR_futex, &wakeups, FUTEX_WAIT_PRIVATE, seen, nullptr, nullptr, 0);
+                }
+                idle.store(false, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Start() {
+        // 所有 LOG 宏都已在编译期去除时没有需要写出的日志，不创建线程
+        if (RANDOMID_LOG_LEVEL > ANDROID_LOG_ERROR) return;
+        static std::once_flag once;
+        std::call_once(once, [] {
+            // ringKey 先于 started 发布，写者看到 started 时一定可以使用它
+            if (pthread_key_create(&ringKey, ReleaseRing) != 0) return;
+            started.store(true, std::memory_order_release);
+            std::thread(DrainLoop).detach();
+        });
+    }
+
+    void Write(int prio, const char *fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        if (!started.load(std::memory_order_acquire)) {
+            char text[kRecordSize];
+            vsnprintf(text, sizeof(text), fmt, args);
+            va_end(args);
+            __android_log_write(prio, LOG_TAG, text);
+            return;
+        }
+
+        Ring *r = t_ring;
+        if (__builtin_expect(r == nullptr, 0)) {
+            r = t_ring = AcquireRing();
+            if (r != nullptr) pthread_setspecific(ringKey, r);
+        }
+        uint32_t head = r ? r->head.load(std::memory_order_relaxed) : 0;
+        uint32_t tail = r ? r->tail.load(std::memory_order_acquire) : 0;
+        if (r == nullptr || head - tail >= kRingRecords) {
+            va_end(args);
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        Record &rec = r->records[head & (kRingRecords - 1)];
+        rec.prio = uint8_t(prio);
+        vsnprintf(rec.text, sizeof(rec.text), fmt, args);
+        va_end(args);
+        r->head.store(head + 1, std::memory_order_release);
+
+        // 只在缓冲区由空变为非空时检查：写出线程空闲等待时才需要系统调用唤醒
+        if (head == tail) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (idle.load(std::memory_order_relaxed)) Wake();
+        }
+    }
+
+    size_t Drain() {
+        size_t count = DrainAll();
+        // 与写出线程交错时可能留下未唤醒它的记录
+        if (AnyPending()) Wake();
+        return count;
+    }
+
+    uint64_t Dropped() {
+        return dropped.load(std::memory_order_relaxed);
+    }
+}
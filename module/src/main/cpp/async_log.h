@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 异步日志后端：Hook 线程只把格式化好的记录写进本线程的 SPSC 环形缓冲区，
+// 由一个低优先级线程统一写给 logd。缓冲区满时直接丢弃并计数，Hook 延迟不受 logd 反压影响。
+// 后台线程只能在应用进程专属化之后启动（zygote 中不能留下线程），启动前的日志同步写出。
+// 写出线程没有日志时阻塞在 futex 上，不做周期唤醒；同一优先级的连续记录合并为一次 logd 写入。
+namespace AsyncLog {
+    // 启动后台写出线程，重复调用无效；RANDOMID_LOG_LEVEL 去除了全部日志时不启动
+    void Start();
+
+    // 格式化一条日志；未启动时同步调用 __android_log_write
+    void Write(int prio, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    // 在调用线程中写出所有已提交的日志，返回条数（与后台线程互斥，供测试和退出前使用）
+    size_t Drain();
+
+    // 因缓冲区满而丢弃的日志条数
+    uint64_t Dropped();
+}
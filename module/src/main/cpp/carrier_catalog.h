@@ -0,0 +1,203 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "id_format.h"
+
+// 运营商目录：以 MCC/MNC 为键，包含运营商名称、ICCID 发卡方前缀和号段。
+// 一次抽取运营商即可派生出相互一致的 SimOperator / ICCID / IMSI / 手机号。
+//
+// 整个目录在编译期生成为一块 4 KB 对齐的只读二进制映像（kImage），独占自己的页：
+// 它随 so 文件映射进每个进程，但只有真正查询目录的目标进程才会缺页读入，
+// 非目标进程永远不会触碰这些页。MCC/MNC 查询通过编译期构建的开放寻址哈希索引完成，O(1)。
+namespace Carrier {
+    inline constexpr size_t kMaxPrefixes = 24;
+    inline constexpr size_t kNameLen = 16;
+
+    struct Entry {
+        uint16_t mcc;
+        uint16_t mnc;
+        uint8_t mnc_digits;         // 2 或 3
+        uint8_t prefix_count;
+        uint8_t weight;             // 被抽中的相对权重（总和为 kPickSlots）
+        char name[kNameLen];
+        char iccid_issuer[7];       // ICCID 前 6 位：89 + 国家码 + 发卡方
+        char prefixes[kMaxPrefixes][4];  // 手机号 3 位号段
+    };
+
+    // 一张 SIM 卡的完整、相互一致的标识
+    struct SimIdentity {
+        char sim_operator[7];       // MCC + MNC
+        char operator_name[kNameLen];
+        char iccid[21];             // 20 位，末位 Luhn
+        char imsi[16];              // 15 位
+        char msisdn[12];            // 11 位
+    };
+
+    namespace detail {
+        inline constexpr char kCmPrefixes[][4] = {"134", "135", "136", "137", "138", "139", "147", "150", "151", "152",
+                                                  "157", "158", "159", "178", "182", "183", "184", "187", "188", "198"};
+        inline constexpr char kCuPrefixes[][4] = {"130", "131", "132", "145", "155", "156", "166", "175", "176", "185",
+                                                  "186"};
+        inline constexpr char kCtPrefixes[][4] = {"133", "149", "153", "173", "177", "180", "181", "189", "191", "199"};
+
+        template <size_t N>
+        constexpr Entry MakeEntry(uint16_t mcc, uint16_t mnc, uint8_t weight, const char (&name)[N],
+                                  const char (&issuer)[7], const auto &prefixes) {
+            Entry e{};
+            e.mcc = mcc;
+            e.mnc = mnc;
+            e.mnc_digits = 2;
+            e.weight = weight;
+            static_assert(N <= kNameLen);
+            for (size_t i = 0; i < N; i++) e.name[i] = name[i];
+            for (size_t i = 0; i < 7; i++) e.iccid_issuer[i] = issuer[i];
+            e.prefix_count = uint8_t(std::size(prefixes));
+            for (size_t p = 0; p < std::size(prefixes); p++) {
+                for (size_t i = 0; i < 4; i++) e.prefixes[p][i] = prefixes[p][i];
+            }
+            return e;
+        }
+    }
+
+    inline constexpr size_t kPickSlots = 64;
+    inline constexpr size_t kIndexSlots = 32;  // 2 的幂，装载率 < 1/2
+
+    // 对齐并填充到整页，保证目录独占自己的页，不会因相邻数据被访问而提前读入
+    struct alignas(4096) Image {
+        uint32_t magic;
+        uint32_t count;
+        std::array<Entry, 9> entries;
+        std::array<uint8_t, kPickSlots> pick;     // 按权重展开的抽样表
+        std::array<uint8_t, kIndexSlots> index;   // MCC/MNC 哈希索引，0xff 为空
+    };
+
+    constexpr uint32_t Key(uint16_t mcc, uint16_t mnc, uint8_t mnc_digits) {
+        return uint32_t(mcc) << 12 | uint32_t(mnc_digits) << 10 | mnc;
+    }
+
+    constexpr size_t Slot(uint32_t key) { return (key * 0x9e3779b1u) >> (32 - 5); }
+    static_assert(kIndexSlots == 1u << 5);
+
+    static_assert(sizeof(Image) == 4096);
+
+    inline constexpr Image kImage = [] {
+        using detail::MakeEntry;
+        Image img{};
+        img.magic = 0x52524143;  // "CARR"
+        img.entries = {
+                MakeEntry(460, 0, 16, "China Mobile", "898600", detail::kCmPrefixes),
+                MakeEntry(460, 2, 8, "China Mobile", "898602", detail::kCmPrefixes),
+                MakeEntry(460, 7, 8, "China Mobile", "898607", detail::kCmPrefixes),
+                MakeEntry(460, 1, 8, "China Unicom", "898601", detail::kCuPrefixes),
+                MakeEntry(460, 6, 4, "China Unicom", "898601", detail::kCuPrefixes),
+                MakeEntry(460, 9, 2, "China Unicom", "898601", detail::kCuPrefixes),
+                MakeEntry(460, 3, 8, "China Telecom", "898603", detail::kCtPrefixes),
+                MakeEntry(460, 5, 2, "China Telecom", "898603", detail::kCtPrefixes),
+                MakeEntry(460, 11, 8, "China Telecom", "898611", detail::kCtPrefixes),
+        };
+        img.count = uint32_t(img.entries.size());
+
+        size_t slot = 0;
+        for (size_t i = 0; i < img.entries.size(); i++) {
+            for (size_t w = 0; w < img.entries[i].weight; w++) img.pick[slot++] = uint8_t(i);
+        }
+
+        for (auto &s : img.index) s = 0xff;
+        for (size_t i = 0; i < img.entries.size(); i++) {
+            const Entry &e = img.entries[i];
+            size_t s = Slot(Key(e.mcc, e.mnc, e.mnc_digits));
+            while (img.index[s] != 0xff) s = (s + 1) % kIndexSlots;
+            img.index[s] = uint8_t(i);
+        }
+        return img;
+    }();
+
+    constexpr bool Validate() {
+        size_t total = 0;
+        for (const Entry &e : kImage.entries) {
+            total += e.weight;
+            if (e.prefix_count == 0 || e.prefix_count > kMaxPrefixes) return false;
+            if (e.mnc_digits != 2 && e.mnc_digits != 3) return false;
+            for (size_t i = 0; i < 6; i++) {
+                if (!IdFormat::detail::IsDigit(e.iccid_issuer[i])) return false;
+            }
+        }
+        return total == kPickSlots;
+    }
+    static_assert(Validate(), "运营商目录数据不合法（权重总和须为 kPickSlots）");
+
+    // 按 MCC/MNC 查询，未收录返回 nullptr
+    inline const Entry *Find(uint16_t mcc, uint16_t mnc, uint8_t mnc_digits = 2) {
+        uint32_t key = Key(mcc, mnc, mnc_digits);
+        for (size_t s = Slot(key);; s = (s + 1) % kIndexSlots) {
+            uint8_t i = kImage.index[s];
+            if (i == 0xff) return nullptr;
+            const Entry &e = kImage.entries[i];
+            if (Key(e.mcc, e.mnc, e.mnc_digits) == key) return &e;
+        }
+    }
+
+    // 按 SimOperator 字符串（MCC + 2 或 3 位 MNC，如 "46001"）查询
+    inline const Entry *Find(const char *plmn) {
+        uint32_t v = 0;
+        size_t len = 0;
+        for (; len < 6 && IdFormat::detail::IsDigit(plmn[len]); len++) v = v * 10 + uint32_t(plmn[len] - '0');
+        if (len < 5 || plmn[len] != '\0') return nullptr;
+        uint32_t scale = len == 6 ? 1000 : 100;
+        return Find(uint16_t(v / scale), uint16_t(v % scale), uint8_t(len - 3));
+    }
+
+    // 按权重随机抽取运营商
+    template <typename Rng>
+    inline const Entry &Pick(Rng &rng) {
+        return kImage.entries[kImage.pick[rng() % kPickSlots]];
+    }
+
+    // 为指定运营商生成一套 SIM 标识
+    template <typename Rng>
+    inline void Generate(const Entry &e, SimIdentity &out, Rng &rng) {
+        using IdFormat::detail::Bounded;
+        using IdFormat::detail::FillDigits;
+
+        // SimOperator / IMSI 前缀：MCC + MNC（按位数补零）
+        char plmn[7];
+        size_t plmn_len = 3 + e.mnc_digits;
+        uint32_t v = uint32_t(e.mcc) * (e.mnc_digits == 3 ? 1000 : 100) + e.mnc;
+        for (size_t i = plmn_len; i > 0; i--) {
+            plmn[i - 1] = char('0' + v % 10);
+            v /= 10;
+        }
+        plmn[plmn_len] = '\0';
+        for (size_t i = 0; i <= plmn_len; i++) out.sim_operator[i] = plmn[i];
+
+        for (size_t i = 0; i < kNameLen; i++) out.operator_name[i] = e.name[i];
+
+        // ICCID：发卡方 6 位 + 13 位 + Luhn
+        for (size_t i = 0; i < 6; i++) out.iccid[i] = e.iccid_issuer[i];
+        FillDigits(out.iccid + 6, 13, rng);
+        out.iccid[19] = IdFormat::detail::LuhnDigit(out.iccid, 19);
+        out.iccid[20] = '\0';
+
+        // IMSI：MCC + MNC + MSIN，共 15 位
+        for (size_t i = 0; i < plmn_len; i++) out.imsi[i] = plmn[i];
+        FillDigits(out.imsi + plmn_len, 15 - plmn_len, rng);
+        out.imsi[15] = '\0';
+
+        // 手机号：运营商号段 + 8 位
+        const char *prefix = e.prefixes[Bounded(e.prefix_count, rng)];
+        out.msisdn[0] = prefix[0];
+        out.msisdn[1] = prefix[1];
+        out.msisdn[2] = prefix[2];
+        FillDigits(out.msisdn + 3, 8, rng);
+        out.msisdn[11] = '\0';
+    }
+
+    // 抽取运营商并生成一致的 SIM 标识
+    template <typename Rng>
+    inline void Generate(SimIdentity &out, Rng &rng) {
+        IdFormat::detail::CheckEngine<Rng>();
+        Generate(Pick(rng), out, rng);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+
+// 低开销时间戳：aarch64 读虚拟计数器 CNTVCT_EL0，x86 读 TSC，其余平台退回 clock_gettime。
+// 热路径只取原始计数，换算成纳秒留给离线工具（Frequency() 写进文件头）。
+namespace CycleClock {
+    inline uint64_t MonotonicNs() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return uint64_t(ts.tv_sec) * 1000000000 + uint64_t(ts.tv_nsec);
+    }
+
+    inline uint64_t Now() {
+#if defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#elif defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        return MonotonicNs();
+#endif
+    }
+
+    // 每秒计数。aarch64 直接读 CNTFRQ_EL0；x86 用 2ms 忙等校准一次并缓存
+    inline uint64_t Frequency() {
+#if defined(__aarch64__)
+        uint64_t freq;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+        return freq;
+#elif defined(__x86_64__) || defined(__i386__)
+        static const uint64_t freq = [] {
+            uint64_t ns0 = MonotonicNs(), t0 = Now(), ns1;
+            do { ns1 = MonotonicNs(); } while (ns1 - ns0 < 2000000);
+            uint64_t t1 = Now();
+            return uint64_t(double(t1 - t0) * 1e9 / double(ns1 - ns0));
+        }();
+        return freq;
+#else
+        return 1000000000;
+#endif
+    }
+}
@@ -0,0 +1,171 @@
+#include "device_hooks.h"
+#include "hook_stats.h"
+#include "hook_trace.h"
+#include "jni_cache.h"
+#include "settings_keys.h"
+#include "log.h"
+
+namespace DeviceHooks {
+    namespace {
+        // 被拦截的系统属性与 MediaDrm 属性名
+        constexpr char kPropHardware[] = "ro.hardware";
+        constexpr char kPropBootHardware[] = "ro.boot.hardware";
+        constexpr char kPropSimOperator[] = "gsm.sim.operator.numeric";
+        constexpr char kDrmDeviceUniqueId[] = "deviceUniqueId";
+
+        template <size_t N>
+        constexpr jsize Len(const char (&)[N]) { return jsize(N - 1); }
+
+        template <size_t N>
+        bool Matches(const jchar *chars, jsize len, const char (&ascii)[N]) {
+            if (len != Len(ascii)) return false;
+            for (jsize i = 0; i < len; i++) {
+                if (chars[i] != jchar(ascii[i])) return false;
+            }
+            return true;
+        }
+
+        // 长度与 ascii 相同才复制到栈上逐字比较，其余名字只付出一次 GetStringLength
+        template <size_t N>
+        bool Equals(JNIEnv *env, jstring str, const char (&ascii)[N]) {
+            if (str == nullptr || env->GetStringLength(str) != Len(ascii)) return false;
+            jchar buf[N - 1];
+            env->GetStringRegion(str, 0, Len(ascii), buf);
+            return Matches(buf, Len(ascii), ascii);
+        }
+    }
+
+    // 各设备标识Hook实现
+    const char* hookGetDeviceId(JNIEnv* env, jobject thiz) {
+        HOOK_STATS(GetDeviceId);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random IMEI: %s", identity.imei);
+        TRACE_HOOK(ReturnImei, identity.imei, 0);
+        return identity.imei;
+    }
+
+    const char* hookGetImei(JNIEnv* env, jobject thiz, int slot) {
+        HOOK_STATS(GetImei);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random IMEI (slot %d): %s", slot, identity.imei);
+        TRACE_HOOK(ReturnImeiSlot, identity.imei, uint32_t(slot));
+        return identity.imei;
+    }
+
+    const char* hookGetMacAddr(JNIEnv* env, jobject thiz) {
+        HOOK_STATS(GetMacAddr);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random MAC: %s", identity.mac);
+        TRACE_HOOK(ReturnMac, identity.mac, 0);
+        return identity.mac;
+    }
+
+    jstring hookGetSettingsString(JNIEnv* env, jobject thiz, jobject contentResolver, jstring key) {
+        HOOK_STATS(GetSettingsString);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        switch (SettingsKeys::Resolve(env, key)) {
+            case SettingsKeys::Key::AndroidId:
+                LOGI("Return random Android ID: %s", identity.android_id);
+                TRACE_HOOK(ReturnAndroidId, identity.android_id, 0);
+                return JniCache::AndroidId(env);
+            case SettingsKeys::Key::BluetoothAddress:
+                LOGI("Return random Bluetooth address: %s", identity.bluetooth_mac);
+                TRACE_HOOK(ReturnBluetoothAddress, identity.bluetooth_mac, 0);
+                return JniCache::BluetoothAddress(env);
+            case SettingsKeys::Key::BluetoothName:
+                LOGI("Return random Bluetooth name: %s", identity.bluetooth_name);
+                TRACE_HOOK(ReturnBluetoothName, identity.bluetooth_name, 0);
+                return JniCache::BluetoothName(env);
+            case SettingsKeys::Key::None:
+                break;
+        }
+        // 其他键交给原函数处理
+        return origGetSettingsString(env, thiz, contentResolver, key);
+    }
+
+    // BSSID 与本机 MAC 使用同一个伪造值，但原函数槽独立
+    const char* hookGetBssid(JNIEnv* env, jobject thiz) {
+        HOOK_STATS(GetBssid);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random BSSID: %s", identity.mac);
+        TRACE_HOOK(ReturnBssid, identity.mac, 0);
+        return identity.mac;
+    }
+
+    const char* hookGetHardware() {
+        HOOK_STATS(GetHardware);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random Hardware ID: %s", identity.hardware_id);
+        TRACE_HOOK(ReturnHardware, identity.hardware_id, 0);
+        return identity.hardware_id;
+    }
+
+    const char* hookGetLine1Number(JNIEnv* env, jobject thiz) {
+        HOOK_STATS(GetLine1Number);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random Mobile No: %s", identity.mobile);
+        TRACE_HOOK(ReturnMobile, identity.mobile, 0);
+        return identity.mobile;
+    }
+
+    const char* hookGetSimSerial(JNIEnv* env, jobject thiz) {
+        HOOK_STATS(GetSimSerial);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random Sim Serial: %s", identity.sim_serial);
+        TRACE_HOOK(ReturnSimSerial, identity.sim_serial, 0);
+        return identity.sim_serial;
+    }
+
+    const char* hookGetSimOperator(JNIEnv* env, jobject thiz) {
+        HOOK_STATS(GetSimOperator);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random Sim Operator: %s", identity.sim_operator);
+        TRACE_HOOK(ReturnSimOperator, identity.sim_operator, 0);
+        return identity.sim_operator;
+    }
+
+    jbyteArray hookGetMediaDrmUniqueId(JNIEnv* env, jobject thiz) {
+        HOOK_STATS(GetMediaDrmUniqueId);
+        const IdentityRecord &identity = IdentitySnapshot::Get();
+        LOGI("Return random MediaDrm ID: %s", identity.media_drm_id);
+        TRACE_HOOK(ReturnMediaDrmId, identity.media_drm_id, 0);
+        return JniCache::MediaDrmId(env);
+    }
+
+    // JNI 重绑定：Java 层 SystemProperties.get 的 native 入口
+    jstring hookSysPropGet(JNIEnv* env, jclass clazz, jstring key, jstring def) {
+        HOOK_STATS(SysPropGet);
+        if (key != nullptr) {
+            jsize len = env->GetStringLength(key);
+            if (len == Len(kPropHardware) || len == Len(kPropBootHardware) || len == Len(kPropSimOperator)) {
+                jchar buf[Len(kPropSimOperator)];
+                env->GetStringRegion(key, 0, len, buf);
+                const IdentityRecord &identity = IdentitySnapshot::Get();
+                if (Matches(buf, len, kPropHardware) || Matches(buf, len, kPropBootHardware)) {
+                    LOGI("Return random ro.hardware: %s", identity.hardware_id);
+                    TRACE_HOOK(ReturnPropHardware, identity.hardware_id, 0);
+                    return JniCache::Hardware(env);
+                }
+                if (Matches(buf, len, kPropSimOperator)) {
+                    LOGI("Return random SIM operator prop: %s", identity.sim_operator);
+                    TRACE_HOOK(ReturnPropSimOperator, identity.sim_operator, 0);
+                    return JniCache::SimOperator(env);
+                }
+            }
+        }
+        // 其他属性交给原函数处理
+        return origSysPropGet(env, clazz, key, def);
+    }
+
+    // JNI 重绑定：MediaDrm.getPropertyByteArray("deviceUniqueId")
+    jbyteArray hookMediaDrmGetProperty(JNIEnv* env, jobject thiz, jstring name) {
+        HOOK_STATS(MediaDrmGetProperty);
+        if (Equals(env, name, kDrmDeviceUniqueId)) {
+            const IdentityRecord &identity = IdentitySnapshot::Get();
+            LOGI("Return random MediaDrm deviceUniqueId: %s", identity.media_drm_id);
+            TRACE_HOOK(ReturnDrmUniqueId, identity.media_drm_id, 0);
+            return JniCache::MediaDrmId(env);
+        }
+        return origMediaDrmGetProperty(env, thiz, name);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <jni.h>
+#include <type_traits>
+#include "hook_table.h"
+#include "jni_table.h"
+#include "identity_snapshot.h"
+
+// 设备标识Hook的实现。与Zygisk模块类分开，
+// 这样不依赖 zygisk.hpp 也能单独编译（宿主机基准测试直接链接本文件）。
+namespace DeviceHooks {
+    // 原函数指针类型 <Hook>Func、每个Hook独立的原函数指针槽 orig<Hook>（由 pltHookRegister /
+    // hookJniNativeMethods 写入），以及Hook实现 hook<Hook> 的声明：均由 hook_defs.h 的表生成
+#define X(id, num, type, ...)                             \
+    using id##Func = type;                                \
+    inline constinit id##Func orig##id = nullptr;         \
+    std::remove_pointer_t<id##Func> hook##id;
+    RANDOMID_HOOK_TABLE(X)
+    RANDOMID_JNI_TABLE(X)
+#undef X
+
+    // 按 PLT 表的行下标索引的注册信息：Hook 实现与原函数槽
+    struct Binding {
+        void *handler;
+        void **orig;
+    };
+
+    inline const Binding kBindings[] = {
+#define X(id, ...) {reinterpret_cast<void *>(hook##id), reinterpret_cast<void **>(&orig##id)},
+            RANDOMID_HOOK_TABLE(X)
+#undef X
+    };
+    static_assert(std::size(kBindings) == HookTable::kCount);
+
+    // 按 JNI 表下标索引，handler 写入 JNINativeMethod.fnPtr，hookJniNativeMethods 换回的原指针存入 orig
+    inline const Binding kJniBindings[] = {
+#define X(id, ...) {reinterpret_cast<void *>(hook##id), reinterpret_cast<void **>(&orig##id)},
+            RANDOMID_JNI_TABLE(X)
+#undef X
+    };
+    static_assert(std::size(kJniBindings) == JniTable::kCount);
+}
@@ -0,0 +1,22 @@
+#include "got_patch.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include "log.h"
+
+namespace GotPatch {
+    bool Apply(uintptr_t slot, bool relro, void *handler, void **orig) {
+        static const uintptr_t kPageSize = uintptr_t(sysconf(_SC_PAGESIZE));
+        auto *page = reinterpret_cast<void *>(slot & ~(kPageSize - 1));
+        // 槽不会跨页：GOT 项按指针大小对齐。
+        // 缓存的 RELRO 标志算错时直接写只读页就是 SIGSEGV，所以写入前总是先 mprotect
+        if (mprotect(page, kPageSize, PROT_READ | PROT_WRITE) != 0) {
+            LOGW("Cannot unprotect GOT page %p", page);
+            return false;
+        }
+        auto *entry = reinterpret_cast<void **>(slot);
+        *orig = __atomic_load_n(entry, __ATOMIC_RELAXED);
+        __atomic_store_n(entry, handler, __ATOMIC_RELEASE);
+        if (relro) mprotect(page, kPageSize, PROT_READ);
+        return true;
+    }
+}
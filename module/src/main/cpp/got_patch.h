@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+
+// 直接改写导入方的 GOT 槽：HookResolver 已经定位好唯一的 JUMP_SLOT，
+// 每个目标应用只需一次指针写入（前后各一次 mprotect），不必再让 pltHookCommit 扫描 maps 与全部 ELF。
+namespace GotPatch {
+    // 槽中原有的函数地址写入 *orig，然后换成 handler。
+    // 不论 relro 如何，写入前都先把槽所在页设为可写；relro 只决定写完后是否把该页恢复为只读
+    bool Apply(uintptr_t slot, bool relro, void *handler, void **orig);
+}
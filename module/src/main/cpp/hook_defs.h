@@ -0,0 +1,59 @@
+#pragma once
+
+// Hook 定义表：新增 Hook = 在这里追加一行 + 在 device_hooks.cpp 中写出 hook<名字> 的实现。
+// HookId 枚举（hook_ids.h）、原函数类型与原函数槽、Hook 实现的声明（device_hooks.h）、
+// 注册表（hook_table.h / jni_table.h）与追踪事件（hook_trace.h）都由这两张表在编译期生成。
+//
+// 每行第二列是 HookId 的数值：写入追踪与统计文件，一经发布不可更改，新 Hook 取下一个未用的编号，
+// 不论加在哪张表（hook_ids.h 中 static_assert 检查编号不重复且连续）。
+// 每行最后一列是该 Hook 的追踪事件序列 E(事件名, 文本模板)，模板中 {ret} 为返回值哈希，{arg} 为附加参数；
+// 事件在所属 Hook 内按出现顺序编号，同样只能追加。
+
+// PLT Hook：(Hook 名, 编号, 函数类型, 库正则, 符号, 策略, 追踪事件)。
+// 库正则与 Zygisk 一样匹配 /proc/self/maps 中导入方库的完整路径，因此以 "/" 开头、"$" 结尾。
+#define RANDOMID_HOOK_TABLE(X)                                                                                  \
+    X(GetDeviceId, 0, const char *(*)(JNIEnv *, jobject), "/libandroid_runtime\\.so$",                          \
+      "_ZN7android19TelephonyManager_getDeviceIdEP7_JNIEnvP8_jobject", HookPolicy::Optional,                    \
+      E(ReturnImei, "Return random IMEI #{ret}"))                                                               \
+    X(GetImei, 1, const char *(*)(JNIEnv *, jobject, int), "/libandroid_runtime\\.so$",                         \
+      "_ZN7android17TelephonyManager_getImeiEP7_JNIEnvP8_jobjecti", HookPolicy::Optional,                       \
+      E(ReturnImeiSlot, "Return random IMEI (slot {arg}) #{ret}"))                                              \
+    X(GetMacAddr, 2, const char *(*)(JNIEnv *, jobject), "/libandroid_runtime\\.so$",                           \
+      "_ZN7android13WifiInfo_getMacAddressEP7_JNIEnvP8_jobject", HookPolicy::Optional,                          \
+      E(ReturnMac, "Return random MAC #{ret}"))                                                                 \
+    X(GetSettingsString, 3, jstring (*)(JNIEnv *, jobject, jobject, jstring), "/libandroid_runtime\\.so$",      \
+      "_ZN7android17Settings_Secure_getStringEP7_JNIEnvP8_jobjectP8_jobjectP8_jstring",                         \
+      HookPolicy::Optional,                                                                                     \
+      E(ReturnAndroidId, "Return random Android ID #{ret}")                                                     \
+      E(ReturnBluetoothAddress, "Return random Bluetooth address #{ret}")                                       \
+      E(ReturnBluetoothName, "Return random Bluetooth name #{ret}"))                                            \
+    X(GetHardware, 4, const char *(*)(), "/libandroid_runtime\\.so$", "_ZN7android5Build_getHardwareEv",        \
+      HookPolicy::Optional, E(ReturnHardware, "Return random Hardware ID #{ret}"))                              \
+    X(GetLine1Number, 5, const char *(*)(JNIEnv *, jobject), "/libandroid_runtime\\.so$",                       \
+      "_ZN7android23TelephonyManager_getLine1NumberEP7_JNIEnvP8_jobject", HookPolicy::Optional,                 \
+      E(ReturnMobile, "Return random Mobile No #{ret}"))                                                        \
+    X(GetSimSerial, 6, const char *(*)(JNIEnv *, jobject), "/libandroid_runtime\\.so$",                         \
+      "_ZN7android25TelephonyManager_getSimSerialNumberEP7_JNIEnvP8_jobject", HookPolicy::Optional,             \
+      E(ReturnSimSerial, "Return random Sim Serial #{ret}"))                                                    \
+    X(GetSimOperator, 7, const char *(*)(JNIEnv *, jobject), "/libandroid_runtime\\.so$",                       \
+      "_ZN7android24TelephonyManager_getSimOperatorEP7_JNIEnvP8_jobject", HookPolicy::Optional,                 \
+      E(ReturnSimOperator, "Return random Sim Operator #{ret}"))                                                \
+    X(GetMediaDrmUniqueId, 8, jbyteArray (*)(JNIEnv *, jobject), "/libmediadrm\\.so$",                          \
+      "_ZN7android7MediaDrm11getUniqueIdEP7_JNIEnvP8_jobject", HookPolicy::Optional,                            \
+      E(ReturnMediaDrmId, "Return random MediaDrm ID #{ret}"))                                                  \
+    X(GetBssid, 9, const char *(*)(JNIEnv *, jobject), "/libandroid_runtime\\.so$",                             \
+      "_ZN7android11WifiInfo_getBssidEP7_JNIEnvP8_jobject", HookPolicy::Optional,                               \
+      E(ReturnBssid, "Return random BSSID #{ret}"))
+
+// JNI 重绑定：(Hook 名, 编号, 函数类型, 类名, 方法名, 签名, 方法类型, 追踪事件)。
+// Java 调 native 方法走 ART 的 JNI 入口，不经过任何 PLT 桩，只能通过 hookJniNativeMethods 替换注册的函数指针。
+// 同一个类的行必须相邻：每个类只做一次 FindClass、一次 hookJniNativeMethods（jni_table.h 中 static_assert 检查）。
+// Settings.Secure.getString 是纯 Java 方法，没有可以重绑定的 native 入口，仍由 PLT 表覆盖。
+#define RANDOMID_JNI_TABLE(X)                                                                                   \
+    X(SysPropGet, 10, jstring (*)(JNIEnv *, jclass, jstring, jstring), "android/os/SystemProperties",           \
+      "native_get", "(Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;", JniKind::Static,                \
+      E(ReturnPropHardware, "Return random ro.hardware #{ret}")                                                 \
+      E(ReturnPropSimOperator, "Return random SIM operator prop #{ret}"))                                       \
+    X(MediaDrmGetProperty, 11, jbyteArray (*)(JNIEnv *, jobject, jstring), "android/media/MediaDrm",            \
+      "getPropertyByteArray", "(Ljava/lang/String;)[B", JniKind::Instance,                                      \
+      E(ReturnDrmUniqueId, "Return random deviceUniqueId #{ret}"))
@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include "hook_defs.h"
+
+// Hook 编号：写入追踪与统计文件，数值取自 hook_defs.h 每行的编号列，一经发布不可更改。
+// 新 Hook 无论加在 PLT 表还是 JNI 表，都取下一个未用的编号，已有编号保持不变。
+namespace HookIds {
+    inline constexpr uint16_t kValues[] = {
+#define X(name, id, ...) id,
+            RANDOMID_HOOK_TABLE(X)
+            RANDOMID_JNI_TABLE(X)
+#undef X
+    };
+
+    inline constexpr size_t kCount = std::size(kValues);
+
+    // 编号必须恰好是 0..kCount-1 的一个排列：统计文件按编号直接索引
+    static_assert([] {
+        bool seen[kCount] = {};
+        for (uint16_t id : kValues) {
+            if (id >= kCount || seen[id]) return false;
+            seen[id] = true;
+        }
+        return true;
+    }(), "hook_defs.h 中的 Hook 编号必须不重复且连续");
+}
+
+enum class HookId : uint16_t {
+#define X(name, id, ...) name = id,
+    RANDOMID_HOOK_TABLE(X)
+    RANDOMID_JNI_TABLE(X)
+#undef X
+    kCount = HookIds::kCount
+};
+
+// 按编号排列的 Hook 名
+inline constexpr auto kHookNames = [] {
+    std::array<const char *, size_t(HookId::kCount)> names{};
+#define X(name, id, ...) names[id] = #name;
+    RANDOMID_HOOK_TABLE(X)
+    RANDOMID_JNI_TABLE(X)
+#undef X
+    return names;
+}();
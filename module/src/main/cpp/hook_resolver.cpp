@@ -0,0 +1,282 @@
+#include "hook_resolver.h"
+#include <cstdio>
+#include <cstring>
+#include <elf.h>
+#include <link.h>
+#include <regex.h>
+#include <unistd.h>
+#include "symbol_cache.h"
+#include "xdl.h"
+#include "log.h"
+
+#ifndef DT_ANDROID_REL
+#define DT_ANDROID_REL (DT_LOOS + 2)
+#define DT_ANDROID_RELA (DT_LOOS + 4)
+#endif
+
+#if defined(__LP64__)
+#define ELF_R_SYM(info) ELF64_R_SYM(info)
+using ElfRel = ElfW(Rela);
+#else
+#define ELF_R_SYM(info) ELF32_R_SYM(info)
+using ElfRel = ElfW(Rel);
+#endif
+
+namespace HookResolver {
+    namespace {
+        constexpr size_t kMaxLibraries = 4;
+
+        // 一个匹配到的库及其上各目标的解析标志（SymbolCache::Flags）
+        struct Library {
+            char path[256];
+            ElfW(Addr) bias;
+            uint64_t build_id;
+            bool cached;                      // 所有目标都在缓存中命中，没有解析 ELF
+            uint32_t flags[HookTable::kCount];
+            uint64_t got[HookTable::kCount];  // JUMP_SLOT 槽相对加载基址的偏移
+            ElfW(Addr) relro_begin;           // PT_GNU_RELRO 触及的整页范围（相对加载基址）
+            ElfW(Addr) relro_end;
+            uint32_t refs[HookTable::kCount]; // 引用该符号的重定位条数
+        };
+
+        // 一个库正则对应的所有待检查目标
+        struct Scan {
+            regex_t regex;
+            const HookTable::Group *group;
+            Library libs[kMaxLibraries];
+            size_t count;
+        };
+
+        // bionic 不改写 .dynamic；glibc 会把地址改写成已加上 bias 的值
+        uintptr_t DynPtr(ElfW(Addr) bias, ElfW(Addr) ptr) {
+            return ptr >= bias ? ptr : bias + ptr;
+        }
+
+        // jumpSlots 为 true 时扫描的是 DT_JMPREL，命中的条目记下 GOT 槽位置
+        void ScanRelocs(const Scan &scan, Library &lib, uintptr_t relocs, size_t size, const ElfW(Sym) *symtab,
+                        const char *strtab, bool jumpSlots) {
+            if (relocs == 0 || size == 0) return;
+            auto *rel = reinterpret_cast<const ElfRel *>(relocs);
+            size_t count = size / sizeof(ElfRel);
+            for (size_t r = 0; r < count; r++) {
+                size_t sym = ELF_R_SYM(rel[r].r_info);
+                if (sym == 0) continue;
+                const char *name = strtab + symtab[sym].st_name;
+                for (size_t i = scan.group->begin; i < scan.group->end; i++) {
+                    size_t id = HookTable::kOrder[i];
+                    if (strcmp(name, HookTable::kTargets[id].symbol) != 0) continue;
+                    lib.flags[id] |= SymbolCache::Flags::Imported;
+                    lib.refs[id]++;
+                    if (jumpSlots) lib.got[id] = rel[r].r_offset;
+                }
+            }
+        }
+
+        int OnObject(struct dl_phdr_info *info, size_t, void *arg) {
+            auto &scan = *static_cast<Scan *>(arg);
+            if (info->dlpi_name == nullptr || regexec(&scan.regex, info->dlpi_name, 0, nullptr, 0) != 0) return 0;
+
+            if (scan.count == kMaxLibraries) {
+                LOGW("Too many libraries match %s, ignore %s", scan.group->library, info->dlpi_name);
+                return 0;
+            }
+            Library &lib = scan.libs[scan.count++];
+            snprintf(lib.path, sizeof(lib.path), "%s", info->dlpi_name);
+            lib.bias = info->dlpi_addr;
+            lib.build_id = SymbolCache::BuildId(info->dlpi_phdr, info->dlpi_phnum, info->dlpi_addr);
+
+            // 缓存命中：只读了 PT_NOTE，不再解析 .dynamic 与重定位表
+            lib.cached = lib.build_id != 0;
+            for (size_t i = scan.group->begin; i < scan.group->end && lib.cached; i++) {
+                size_t id = HookTable::kOrder[i];
+                const SymbolCache::Entry *entry =
+                        SymbolCache::Find(lib.build_id, SymbolCache::Hash64(HookTable::kTargets[id].symbol));
+                if (entry != nullptr) {
+                    lib.flags[id] = entry->flags;
+                    lib.got[id] = entry->got;
+                } else {
+                    lib.cached = false;
+                }
+            }
+            if (lib.cached) return 0;
+            for (size_t id = 0; id < HookTable::kCount; id++) {
+                lib.flags[id] = 0;
+                lib.got[id] = 0;
+                lib.refs[id] = 0;
+            }
+
+            const ElfW(Dyn) *dyn = nullptr;
+            for (size_t i = 0; i < info->dlpi_phnum; i++) {
+                if (info->dlpi_phdr[i].p_type == PT_DYNAMIC) {
+                    dyn = reinterpret_cast<const ElfW(Dyn) *>(info->dlpi_addr + info->dlpi_phdr[i].p_vaddr);
+                    break;
+                }
+            }
+            if (dyn == nullptr) return 0;
+
+            uintptr_t symtab = 0, strtab = 0, jmprel = 0, rel = 0;
+            size_t pltrelsz = 0, relsz = 0;
+            bool packed = false;
+            for (; dyn->d_tag != DT_NULL; dyn++) {
+                switch (dyn->d_tag) {
+                    case DT_SYMTAB: symtab = DynPtr(info->dlpi_addr, dyn->d_un.d_ptr); break;
+                    case DT_STRTAB: strtab = DynPtr(info->dlpi_addr, dyn->d_un.d_ptr); break;
+                    case DT_JMPREL: jmprel = DynPtr(info->dlpi_addr, dyn->d_un.d_ptr); break;
+                    case DT_PLTRELSZ: pltrelsz = dyn->d_un.d_val; break;
+#if defined(__LP64__)
+                    case DT_RELA: rel = DynPtr(info->dlpi_addr, dyn->d_un.d_ptr); break;
+                    case DT_RELASZ: relsz = dyn->d_un.d_val; break;
+#else
+                    case DT_REL: rel = DynPtr(info->dlpi_addr, dyn->d_un.d_ptr); break;
+                    case DT_RELSZ: relsz = dyn->d_un.d_val; break;
+#endif
+                    case DT_ANDROID_REL:
+                    case DT_ANDROID_RELA: packed = true; break;
+                    default: break;
+                }
+            }
+            if (packed) {
+                for (size_t i = scan.group->begin; i < scan.group->end; i++) {
+                    lib.flags[HookTable::kOrder[i]] |= SymbolCache::Flags::Packed;
+                }
+            }
+            if (symtab == 0 || strtab == 0) return 0;
+            auto *syms = reinterpret_cast<const ElfW(Sym) *>(symtab);
+            auto *strs = reinterpret_cast<const char *>(strtab);
+            ScanRelocs(scan, lib, jmprel, pltrelsz, syms, strs, true);
+            ScanRelocs(scan, lib, rel, relsz, syms, strs, false);
+
+            // 只有一条 JUMP_SLOT 引用、且没有压缩重定位时，改写这一个槽就等价于 PLT Hook。
+            // 链接器对 RELRO 末尾向上取整到页（bionic 的 page_end），段触及的每一页都会被设为只读
+            ElfW(Addr) pageSize = ElfW(Addr)(sysconf(_SC_PAGESIZE)), pageMask = ~(pageSize - 1);
+            for (size_t i = 0; i < info->dlpi_phnum; i++) {
+                if (info->dlpi_phdr[i].p_type == PT_GNU_RELRO) {
+                    lib.relro_begin = info->dlpi_phdr[i].p_vaddr & pageMask;
+                    lib.relro_end = (info->dlpi_phdr[i].p_vaddr + info->dlpi_phdr[i].p_memsz + pageSize - 1) & pageMask;
+                }
+            }
+            for (size_t i = scan.group->begin; i < scan.group->end; i++) {
+                size_t id = HookTable::kOrder[i];
+                if (packed || lib.refs[id] != 1 || lib.got[id] == 0) continue;
+                lib.flags[id] |= SymbolCache::Flags::Got;
+                if (lib.got[id] >= lib.relro_begin && lib.got[id] < lib.relro_end) lib.flags[id] |= SymbolCache::Flags::Relro;
+            }
+            return 0;
+        }
+
+        // 缓存未命中时补全一个库上各目标的标志并写入缓存，之后的启动不再打开 ELF 文件。
+        // 只有既未导入、也没有压缩重定位的目标才需要区分“已定义”与“不存在”（见 Combine），
+        // 这时整个库只打开一次 xdl 句柄，.symtab / .gnu_debugdata 最多载入一次
+        void Define(Library &lib, const HookTable::Group &group) {
+            void *handle = nullptr;
+            bool opened = false;
+            for (size_t i = group.begin; i < group.end; i++) {
+                size_t id = HookTable::kOrder[i];
+                const char *symbol = HookTable::kTargets[id].symbol;
+                if ((lib.flags[id] & (SymbolCache::Flags::Imported | SymbolCache::Flags::Packed)) == 0) {
+                    if (!opened) {
+                        opened = true;
+                        handle = xdl_open(lib.path, XDL_DEFAULT);
+                    }
+                    if (handle != nullptr &&
+                        (xdl_sym(handle, symbol, nullptr) != nullptr || xdl_dsym(handle, symbol, nullptr) != nullptr)) {
+                        lib.flags[id] |= SymbolCache::Flags::Defined;
+                    }
+                }
+                if (lib.build_id != 0) {
+                    SymbolCache::Add({lib.build_id, SymbolCache::Hash64(symbol), lib.got[id],
+                                      uint32_t(SymbolCache::Hash64(lib.path)), lib.flags[id]});
+                }
+            }
+            if (handle != nullptr) xdl_close(handle);
+        }
+
+        // 多个库匹配同一个正则时，任何一个导入即可生效
+        Status Combine(const Scan &scan, size_t id) {
+            if (scan.count == 0) return Status::NoLibrary;
+            uint32_t any = 0;
+            for (size_t l = 0; l < scan.count; l++) any |= scan.libs[l].flags[id];
+            if (any & SymbolCache::Flags::Imported) return Status::Imported;
+            if (any & SymbolCache::Flags::Packed) return Status::Unknown;
+            if (any & SymbolCache::Flags::Defined) return Status::DefinedOnly;
+            return Status::Missing;
+        }
+
+        // 只有一个库导入该符号且 GOT 槽唯一时才能直接改写，否则交给 pltHookRegister
+        void LocateSlot(const Scan &scan, size_t id, Result &out) {
+            out.slot[id] = 0;
+            out.slot_relro[id] = false;
+            const Library *only = nullptr;
+            for (size_t l = 0; l < scan.count; l++) {
+                if ((scan.libs[l].flags[id] & (SymbolCache::Flags::Imported | SymbolCache::Flags::Packed)) == 0) continue;
+                if (only != nullptr) return;
+                only = &scan.libs[l];
+            }
+            if (only == nullptr || (only->flags[id] & SymbolCache::Flags::Got) == 0) return;
+            out.slot[id] = only->bias + only->got[id];
+            out.slot_relro[id] = (only->flags[id] & SymbolCache::Flags::Relro) != 0;
+        }
+    }
+
+    void Resolve(Result &out) {
+        out.registered = 0;
+        out.dropped = 0;
+        out.cache_hits = 0;
+        out.cache_misses = 0;
+        for (const HookTable::Group &group : HookTable::kGroups) {
+            Scan scan = {};
+            scan.group = &group;
+            if (regcomp(&scan.regex, group.library, REG_EXTENDED | REG_NOSUB) != 0) {
+                LOGE("Invalid library pattern %s", group.library);
+                for (size_t i = group.begin; i < group.end; i++) {
+                    out.status[HookTable::kOrder[i]] = Status::NoLibrary;
+                    out.slot[HookTable::kOrder[i]] = 0;
+                }
+                out.dropped += group.end - group.begin;
+                continue;
+            }
+            xdl_iterate_phdr(OnObject, &scan, XDL_FULL_PATHNAME);
+            regfree(&scan.regex);
+
+            for (size_t l = 0; l < scan.count; l++) {
+                Library &lib = scan.libs[l];
+                if (lib.cached) {
+                    out.cache_hits += group.end - group.begin;
+                    continue;
+                }
+                Define(lib, group);
+                out.cache_misses += group.end - group.begin;
+            }
+
+            for (size_t i = group.begin; i < group.end; i++) {
+                size_t id = HookTable::kOrder[i];
+                const HookTable::Target &target = HookTable::kTargets[id];
+                Status status = Combine(scan, id);
+                out.status[id] = status;
+                LocateSlot(scan, id, out);
+
+                if (ShouldRegister(status)) {
+                    out.registered++;
+                } else {
+                    out.dropped++;
+                    if (target.policy & HookPolicy::Optional) {
+                        LOGD("Drop hook %s: %s", kHookNames[id], StatusName(status));
+                    } else {
+                        LOGW("Drop hook %s: %s", kHookNames[id], StatusName(status));
+                    }
+                }
+            }
+        }
+    }
+
+    const char *StatusName(Status status) {
+        switch (status) {
+            case Status::Imported: return "imported";
+            case Status::Unknown: return "packed relocations, not verified";
+            case Status::DefinedOnly: return "defined but not imported";
+            case Status::Missing: return "symbol not found";
+            case Status::NoLibrary: return "library not loaded";
+        }
+        return "?";
+    }
+}
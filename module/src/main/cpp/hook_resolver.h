@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+#include "hook_table.h"
+
+// 注册 PLT Hook 之前的解析检查。
+// pltHookRegister 的正则匹配的是“导入方”库的完整路径，只有导入方的重定位表里引用了该符号，
+// Hook 才可能生效。这里用与 Zygisk 相同的方式匹配已加载的库，扫描其 PT_DYNAMIC 中的重定位表；
+// 找不到引用的目标不再注册，并用 xdl_sym / xdl_dsym 区分“符号存在但没人导入”与“符号不存在”。
+// 解析结果按库的 build-id 存入 SymbolCache，之后的启动命中缓存时不再解析 ELF。
+// 导入方只有一条 JUMP_SLOT 引用目标时还给出 GOT 槽地址，由 GotPatch 直接改写，不必经过 pltHookCommit。
+namespace HookResolver {
+    enum class Status : uint8_t {
+        Imported,     // 导入方的重定位表引用了该符号，注册
+        Unknown,      // 导入方含有无法扫描的压缩重定位（APS2），保守起见仍然注册
+        DefinedOnly,  // 符号存在于库中但没有被导入（库内部调用），PLT Hook 不会生效
+        Missing,      // 匹配的库里没有这个符号
+        NoLibrary,    // 正则没有匹配到任何已加载的库
+    };
+
+    struct Result {
+        Status status[HookTable::kCount];
+        uintptr_t slot[HookTable::kCount];   // 可直接改写的 GOT 槽地址，0 表示需要走 pltHookRegister
+        bool slot_relro[HookTable::kCount];  // 槽位于 RELRO，改写后需把所在页恢复为只读
+        uint32_t registered;
+        uint32_t dropped;
+        uint32_t cache_hits;    // 直接由 SymbolCache 得出结果的 (库, 目标) 数
+        uint32_t cache_misses;  // 需要解析 ELF 的 (库, 目标) 数，新结果待 SymbolCache::Flush 写回
+    };
+
+    void Resolve(Result &out);
+
+    inline bool ShouldRegister(Status status) {
+        return status == Status::Imported || status == Status::Unknown;
+    }
+
+    const char *StatusName(Status status);
+}
@@ -0,0 +1,71 @@
+#include "hook_stats.h"
+#include <cstdio>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "log.h"
+
+namespace HookStats {
+    namespace detail {
+        // 只在提交Hook之前写入一次
+        Region *region = nullptr;
+        pthread_key_t shardKey;
+
+        // 线程退出时交还独占分片，计数保留，由下一个线程继续累加（key 的值为分片号 + 1）
+        void ReleaseShard(void *value) {
+            uint32_t shard = uint32_t(reinterpret_cast<uintptr_t>(value)) - 1;
+            region->header.owned[shard].store(0, std::memory_order_release);
+        }
+
+        uint32_t Claim() {
+            uint32_t &shard = Shard();
+            for (uint32_t i = 0; i < kSharedShard; i++) {
+                uint8_t expected = 0;
+                if (region->header.owned[i].compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+                    pthread_setspecific(shardKey, reinterpret_cast<void *>(uintptr_t(i) + 1));
+                    return shard = i;
+                }
+            }
+            return shard = kSharedShard;
+        }
+    }
+
+    bool Open(int moduleDir, const char *pkg) {
+        if (moduleDir < 0 || pkg == nullptr) return false;
+        static const bool keyed = pthread_key_create(&detail::shardKey, detail::ReleaseShard) == 0;
+        if (!keyed) return false;
+        mkdirat(moduleDir, "traces", 0700);
+        char path[256];
+        snprintf(path, sizeof(path), "traces/%s.stats", pkg);
+        int fd = openat(moduleDir, path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            LOGW("Cannot create stats file %s", path);
+            return false;
+        }
+        void *map = MAP_FAILED;
+        if (ftruncate(fd, off_t(sizeof(Region))) == 0) {
+            map = mmap(nullptr, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (map == MAP_FAILED) {
+            LOGW("Cannot map stats file %s", path);
+            return false;
+        }
+
+        // 新截断的文件内容全为 0，计数器无需初始化
+        auto *region = static_cast<Region *>(map);
+        region->header.shards = kShards;
+        region->header.hooks = uint32_t(HookId::kCount);
+        region->header.buckets = kBuckets;
+        region->header.pid = getpid();
+        region->header.ticks_per_sec = CycleClock::Frequency();
+        region->header.version = kVersion;
+        std::atomic_thread_fence(std::memory_order_release);
+        region->header.magic = kMagic;
+        detail::region = region;
+        LOGI("Stats file %s mapped (%zu bytes)", path, sizeof(Region));
+        return true;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "cycle_clock.h"
+#include "hook_ids.h"
+
+// Hook 调用计数与耗时直方图，常驻开启。
+// 数据放在模块目录 traces/<包名>.stats 的共享映射里，randomid_stats 随时读取、不需要暂停应用。
+// 按线程分片而不是按 CPU（每次调用 sched_getcpu 太贵）：线程首次调用时独占一个空闲分片，
+// 独占分片只有一个写者，用 relaxed 读+写累加，没有原子 RMW；分片用完后的线程共用最后一个分片并改用 fetch_add。
+// 耗时按 HDR 风格的对数线性分桶：每个 2 的幂区间再等分 kSubBuckets 份，相对误差 ≤ 25%。
+namespace HookStats {
+    constexpr uint32_t kMagic = 0x54415453;  // "STAT"
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kShards = 8;
+    constexpr uint32_t kSharedShard = kShards - 1;
+    constexpr uint32_t kSubBits = 2;
+    constexpr uint32_t kSubBuckets = 1u << kSubBits;
+    constexpr uint32_t kMaxExp = 39;  // 2^40 个计数以上（24MHz 下约 12 小时）全部落入最后一个桶
+    constexpr uint32_t kBuckets = (kMaxExp - kSubBits + 2) * kSubBuckets;
+
+    static_assert((kShards & (kShards - 1)) == 0);
+
+    // 桶 i 覆盖 [BucketLow(i), BucketLow(i + 1)) 个时钟计数
+    inline constexpr uint32_t Bucket(uint64_t ticks) {
+        if (ticks < kSubBuckets) return uint32_t(ticks);
+        if (ticks >> (kMaxExp + 1)) return kBuckets - 1;
+        uint32_t exp = 63 - uint32_t(__builtin_clzll(ticks));
+        uint32_t sub = uint32_t(ticks >> (exp - kSubBits)) & (kSubBuckets - 1);
+        return (exp - kSubBits + 1) * kSubBuckets + sub;
+    }
+
+    inline constexpr uint64_t BucketLow(uint32_t bucket) {
+        if (bucket < kSubBuckets) return bucket;
+        uint32_t exp = bucket / kSubBuckets + kSubBits - 1;
+        uint64_t sub = bucket % kSubBuckets;
+        return (uint64_t(kSubBuckets) | sub) << (exp - kSubBits);
+    }
+
+    static_assert(Bucket(0) == 0 && Bucket(3) == 3 && Bucket(4) == 4 && Bucket(7) == 7 && Bucket(8) == 8);
+    static_assert(Bucket(~uint64_t(0)) == kBuckets - 1);
+    static_assert(BucketLow(Bucket(1000)) <= 1000 && BucketLow(Bucket(1000) + 1) > 1000);
+
+    struct alignas(64) HookCell {
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> sum_ticks;
+        std::atomic<uint64_t> buckets[kBuckets];
+    };
+
+    struct alignas(4096) Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t shards;
+        uint32_t hooks;
+        uint32_t buckets;
+        int32_t pid;
+        uint64_t ticks_per_sec;
+        std::atomic<uint8_t> owned[kShards];  // 分片是否已被某个线程独占
+    };
+    static_assert(sizeof(Header) == 4096);
+
+    // 文件布局：Header，随后 shards × hooks 个 HookCell（分片优先）
+    struct Region {
+        Header header;
+        HookCell cells[kShards][size_t(HookId::kCount)];
+    };
+
+    // 在模块目录下创建并映射统计文件（需在 preAppSpecialize 中调用）
+    bool Open(int moduleDir, const char *pkg);
+
+    namespace detail {
+        extern Region *region;
+
+        constexpr uint32_t kUnclaimed = UINT32_MAX;
+
+        // 本线程使用的分片，小于 kSharedShard 即为独占。平凡类型的 thread_local 没有析构注册，
+        // 独占分片在线程退出时由 Open 中创建的 pthread key 交还
+        inline uint32_t &Shard() {
+            static thread_local uint32_t shard = kUnclaimed;
+            return shard;
+        }
+
+        uint32_t Claim();
+
+        inline void Add(std::atomic<uint64_t> &counter, uint64_t value, bool exclusive) {
+            if (exclusive) counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            else counter.fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+
+    inline void Record(HookId hook, uint64_t ticks) {
+        Region *region = detail::region;
+        if (region == nullptr) return;
+        uint32_t shard = detail::Shard();
+        if (__builtin_expect(shard == detail::kUnclaimed, 0)) shard = detail::Claim();
+        bool exclusive = shard != kSharedShard;
+        HookCell &cell = region->cells[shard][size_t(hook)];
+        detail::Add(cell.calls, 1, exclusive);
+        detail::Add(cell.sum_ticks, ticks, exclusive);
+        detail::Add(cell.buckets[Bucket(ticks)], 1, exclusive);
+    }
+
+    // 作用域计时器：放在Hook函数体开头
+    class Timer {
+    public:
+        explicit Timer(HookId hook) : hook(hook), start(CycleClock::Now()) {}
+        ~Timer() { Record(hook, CycleClock::Now() - start); }
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+    private:
+        HookId hook;
+        uint64_t start;
+    };
+}
+
+#define HOOK_STATS(hook) HookStats::Timer hookStatsTimer(HookId::hook)
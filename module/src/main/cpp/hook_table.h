@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "hook_ids.h"
+
+// 声明式 Hook 表：行定义在 hook_defs.h 的 RANDOMID_HOOK_TABLE 中。
+// 原函数指针槽、注册顺序与按库分组都由这张表在编译期生成。
+
+// 策略位
+namespace HookPolicy {
+    // 目标符号在多数系统版本上不存在，缺失时只记调试日志
+    inline constexpr uint32_t Optional = 1u << 0;
+}
+
+namespace HookTable {
+    struct Target {
+        HookId id;
+        const char *library;  // pltHookRegister 的库正则（匹配完整路径）
+        const char *symbol;
+        uint32_t policy;
+    };
+
+    inline constexpr Target kTargets[] = {
+#define X(id, num, type, library, symbol, policy, events) {HookId::id, library, symbol, policy},
+            RANDOMID_HOOK_TABLE(X)
+#undef X
+    };
+
+    inline constexpr size_t kCount = std::size(kTargets);
+
+    namespace detail {
+        inline constexpr int Compare(const char *a, const char *b) {
+            for (; *a && *a == *b; a++, b++) {}
+            return int(uint8_t(*a)) - int(uint8_t(*b));
+        }
+    }
+
+    // 按库稳定排序后的注册顺序
+    inline constexpr auto kOrder = [] {
+        std::array<uint8_t, kCount> order{};
+        for (size_t i = 0; i < kCount; i++) order[i] = uint8_t(i);
+        for (size_t i = 1; i < kCount; i++) {
+            for (size_t j = i; j > 0 && detail::Compare(kTargets[order[j - 1]].library, kTargets[order[j]].library) > 0; j--) {
+                uint8_t t = order[j];
+                order[j] = order[j - 1];
+                order[j - 1] = t;
+            }
+        }
+        return order;
+    }();
+
+    // 一个库对应 kOrder 中连续的一段 [begin, end)
+    struct Group {
+        const char *library;
+        uint8_t begin;
+        uint8_t end;
+    };
+
+    inline constexpr size_t kGroupCount = [] {
+        size_t groups = 0;
+        for (size_t i = 0; i < kCount; i++) {
+            if (i == 0 || detail::Compare(kTargets[kOrder[i - 1]].library, kTargets[kOrder[i]].library) != 0) groups++;
+        }
+        return groups;
+    }();
+
+    inline constexpr auto kGroups = [] {
+        std::array<Group, kGroupCount> groups{};
+        size_t g = 0;
+        for (size_t i = 0; i < kCount; i++) {
+            const char *library = kTargets[kOrder[i]].library;
+            if (i == 0 || detail::Compare(groups[g - 1].library, library) != 0) {
+                groups[g++] = {library, uint8_t(i), uint8_t(i + 1)};
+            } else {
+                groups[g - 1].end = uint8_t(i + 1);
+            }
+        }
+        return groups;
+    }();
+}
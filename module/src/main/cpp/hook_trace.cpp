@@ -0,0 +1,78 @@
+#include "hook_trace.h"
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "cycle_clock.h"
+#include "log.h"
+
+namespace HookTrace {
+    namespace {
+        // 只在提交Hook之前写入一次
+        Header *s_header = nullptr;
+        Record *s_records = nullptr;
+
+        // gettid 是系统调用，每个线程只取一次（平凡类型的 thread_local 没有析构注册）
+        uint32_t Tid() {
+            static thread_local uint32_t tid = 0;
+            if (__builtin_expect(tid == 0, 0)) tid = uint32_t(syscall(__NR_gettid));
+            return tid;
+        }
+    }
+
+    bool Open(int moduleDir, const char *pkg) {
+        if (moduleDir < 0 || pkg == nullptr) return false;
+        mkdirat(moduleDir, "traces", 0700);
+        char path[256];
+        snprintf(path, sizeof(path), "traces/%s.trace", pkg);
+        int fd = openat(moduleDir, path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            LOGW("Cannot create trace file %s", path);
+            return false;
+        }
+        size_t size = sizeof(Header) + size_t(kCapacity) * sizeof(Record);
+        void *map = MAP_FAILED;
+        if (ftruncate(fd, off_t(size)) == 0) {
+            map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (map == MAP_FAILED) {
+            LOGW("Cannot map trace file %s", path);
+            return false;
+        }
+
+        auto *header = static_cast<Header *>(map);
+        header->magic = kMagic;
+        header->version = kVersion;
+        header->record_size = sizeof(Record);
+        header->capacity = kCapacity;
+        header->pid = getpid();
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        header->realtime_ns = int64_t(now.tv_sec) * 1000000000 + now.tv_nsec;
+        header->base_ticks = CycleClock::Now();
+        header->ticks_per_sec = CycleClock::Frequency();
+        header->next.store(0, std::memory_order_relaxed);
+        s_records = reinterpret_cast<Record *>(header + 1);
+        s_header = header;
+        LOGI("Trace file %s mapped (%u records)", path, kCapacity);
+        return true;
+    }
+
+    void Emit(TraceEvent event, const char *ret, uint32_t arg, const void *pc) {
+        Header *header = s_header;
+        if (header == nullptr) return;
+        uint64_t seq = header->next.fetch_add(1, std::memory_order_relaxed);
+        Record &rec = s_records[seq & (kCapacity - 1)];
+        rec.ticks = CycleClock::Now();
+        rec.caller_pc = reinterpret_cast<uintptr_t>(pc);
+        rec.tid = Tid();
+        rec.ret_hash = Hash(ret);
+        rec.hook = uint16_t(HookTrace::kEvents[size_t(event)].hook);
+        rec.event = HookTrace::kEvents[size_t(event)].index;
+        rec.arg = arg;
+    }
+}
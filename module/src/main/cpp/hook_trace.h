@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "hook_ids.h"
+
+// 二进制 Hook 追踪：每次Hook调用追加一条 32 字节的定长记录到 mmap 的文件中，
+// 文本格式在编译期编号（X-macro），离线由宿主机工具 randomid_trace_decode 还原为文本 / CSV。
+// 文件位于模块目录 traces/<包名>.trace，每次启动覆盖；写满后从头循环，保留最近的记录。
+
+// 追踪事件由 hook_defs.h 每行的 E(事件名, 文本模板) 生成，所属 Hook 即该行
+enum class TraceEvent : uint16_t {
+#define E(name, text) name,
+#define X(id, num, type, library, symbol, policy, events) events
+    RANDOMID_HOOK_TABLE(X)
+#undef X
+#define X(id, num, type, clazz, name, signature, kind, events) events
+    RANDOMID_JNI_TABLE(X)
+#undef X
+#undef E
+    kCount
+};
+
+namespace HookTrace {
+    struct EventInfo {
+        const char *name;
+        HookId hook;
+        const char *text;
+        uint16_t index;  // 在所属 Hook 内的序号，与 HookId 一起写入记录，不随其他 Hook 增减而变化
+    };
+
+    namespace detail {
+        // 每个 Hook 一个结构体，事件列表中的 kHook 即所在的行
+#define E(name, text) EventInfo{#name, kHook, text},
+#define ROW(id, num, type, library, symbol, policy, events) \
+        struct id {                                      \
+            static constexpr HookId kHook = HookId::id;  \
+            static constexpr std::array kList{events};   \
+        };
+        RANDOMID_HOOK_TABLE(ROW)
+#undef ROW
+#define ROW(id, num, type, clazz, name, signature, kind, events) \
+        struct id {                                         \
+            static constexpr HookId kHook = HookId::id;     \
+            static constexpr std::array kList{events};      \
+        };
+        RANDOMID_JNI_TABLE(ROW)
+#undef ROW
+#undef E
+
+        template <size_t... N>
+        constexpr auto Concat(const std::array<EventInfo, N> &...lists) {
+            std::array<EventInfo, (N + ...)> all{};
+            size_t i = 0;
+            auto append = [&](const auto &list) {
+                for (size_t j = 0; j < list.size(); j++, i++) {
+                    all[i] = list[j];
+                    all[i].index = uint16_t(j);
+                }
+            };
+            (append(lists), ...);
+            return all;
+        }
+    }
+
+    // 按 TraceEvent 编号排列，与上面的枚举同序
+    inline constexpr auto kEvents = detail::Concat(std::array<EventInfo, 0>{}
+#define X(id, ...) , detail::id::kList
+            RANDOMID_HOOK_TABLE(X)
+            RANDOMID_JNI_TABLE(X)
+#undef X
+    );
+
+    static_assert(std::size(kEvents) == size_t(TraceEvent::kCount));
+
+    // 按记录中的 (hook, event) 找回事件，未知的组合返回 nullptr
+    inline constexpr const EventInfo *FindEvent(uint16_t hook, uint16_t index) {
+        for (const EventInfo &ev : kEvents) {
+            if (uint16_t(ev.hook) == hook && ev.index == index) return &ev;
+        }
+        return nullptr;
+    }
+
+    constexpr uint32_t kMagic = 0x43525452;  // "RTRC"
+    constexpr uint32_t kVersion = 2;  // 2：event 改为 Hook 内序号
+    constexpr uint32_t kCapacity = 1 << 16;  // 2 MiB 记录区
+    static_assert((kCapacity & (kCapacity - 1)) == 0);
+
+    struct Record {
+        uint64_t ticks;      // CycleClock 原始计数
+        uint64_t caller_pc;  // Hook 的返回地址
+        uint32_t tid;
+        uint32_t ret_hash;   // 返回值的 FNV-1a，比较两次调用是否一致而不泄露取值
+        uint16_t hook;       // HookId
+        uint16_t event;      // 所属 Hook 内的事件序号（EventInfo::index）
+        uint32_t arg;
+    };
+    static_assert(sizeof(Record) == 32);
+
+    struct alignas(4096) Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t record_size;
+        uint32_t capacity;
+        int32_t pid;
+        uint32_t reserved;
+        int64_t realtime_ns;     // 打开文件时的 CLOCK_REALTIME 与 CycleClock 计数，
+        uint64_t base_ticks;     // 解码时据此把 ticks 换算成墙上时间
+        uint64_t ticks_per_sec;
+        std::atomic<uint64_t> next;  // 已分配的记录序号，取模 capacity 得到位置
+    };
+    static_assert(sizeof(Header) == 4096);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    inline constexpr uint32_t Hash(const char *s) {
+        uint32_t h = 2166136261u;
+        for (; s != nullptr && *s; s++) h = (h ^ uint8_t(*s)) * 16777619u;
+        return h;
+    }
+
+    // 在模块目录下创建并映射追踪文件（需在 preAppSpecialize 中、仍有写权限时调用）
+    bool Open(int moduleDir, const char *pkg);
+
+    // 追加一条记录；未打开时什么也不做
+    void Emit(TraceEvent event, const char *ret, uint32_t arg, const void *pc);
+}
+
+// 在Hook函数体内使用，记录调用者地址
+#define TRACE_HOOK(event, ret, arg) \
+    HookTrace::Emit(TraceEvent::event, (ret), (arg), __builtin_return_address(0))
@@ -0,0 +1,103 @@
+#include "bench.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// 替换全局 operator new 以统计每次操作的堆分配次数
+static std::atomic<uint64_t> g_allocations{0};
+
+void *operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1)) return p;
+    abort();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+namespace Bench {
+    Options &Opts() {
+        static Options options;
+        return options;
+    }
+
+    std::vector<Result> &Results() {
+        static std::vector<Result> results;
+        return results;
+    }
+
+    uint64_t Allocations() {
+        return g_allocations.load(std::memory_order_relaxed);
+    }
+
+    bool Selected(const char *name) {
+        return Opts().filter == nullptr || strstr(name, Opts().filter) != nullptr;
+    }
+
+    void Record(Result result) {
+        std::printf("%-36s %10.1f ns/op %8.2f allocs/op  p50 %8.1f  p99 %8.1f\n",
+                    result.name.c_str(), result.ns_per_op, result.allocs_per_op,
+                    result.p50_ns, result.p99_ns);
+        Results().push_back(std::move(result));
+    }
+
+    // 每个用例一行，Compare 按行解析，不需要完整的 JSON 解析器
+    bool WriteJson(const char *path) {
+        FILE *fp = fopen(path, "w");
+        if (fp == nullptr) return false;
+        fprintf(fp, "{\n  \"benchmarks\": [\n");
+        const auto &results = Results();
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &r = results[i];
+            fprintf(fp, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f, "
+                        "\"p50_ns\": %.3f, \"p99_ns\": %.3f}%s\n",
+                    r.name.c_str(), r.ns_per_op, r.allocs_per_op, r.p50_ns, r.p99_ns,
+                    i + 1 < results.size() ? "," : "");
+        }
+        fprintf(fp, "  ]\n}\n");
+        return fclose(fp) == 0;
+    }
+
+    static bool ParseLine(const char *line, std::string &name, double &nsPerOp, double &allocsPerOp) {
+        const char *p = strstr(line, "\"name\": \"");
+        if (p == nullptr) return false;
+        p += strlen("\"name\": \"");
+        const char *end = strchr(p, '"');
+        if (end == nullptr) return false;
+        name.assign(p, end);
+        const char *ns = strstr(end, "\"ns_per_op\": ");
+        const char *allocs = strstr(end, "\"allocs_per_op\": ");
+        if (ns == nullptr || allocs == nullptr) return false;
+        nsPerOp = strtod(ns + strlen("\"ns_per_op\": "), nullptr);
+        allocsPerOp = strtod(allocs + strlen("\"allocs_per_op\": "), nullptr);
+        return true;
+    }
+
+    int Compare(const char *path, double thresholdPct) {
+        FILE *fp = fopen(path, "r");
+        if (fp == nullptr) return -1;
+        int regressions = 0;
+        char line[512];
+        std::printf("\n%-36s %10s %10s %8s\n", "compare", "base", "now", "delta");
+        while (fgets(line, sizeof(line), fp)) {
+            std::string name;
+            double baseNs, baseAllocs;
+            if (!ParseLine(line, name, baseNs, baseAllocs)) continue;
+            for (const Result &r : Results()) {
+                if (r.name != name) continue;
+                double delta = baseNs > 0 ? (r.ns_per_op - baseNs) / baseNs * 100.0 : 0.0;
+                // 分配次数增加一律视为回退
+                bool regressed = delta > thresholdPct || r.allocs_per_op > baseAllocs + 0.01;
+                std::printf("%-36s %10.1f %10.1f %+7.1f%%%s\n", name.c_str(), baseNs, r.ns_per_op, delta,
+                            regressed ? "  REGRESSION" : "");
+                regressions += regressed;
+            }
+        }
+        fclose(fp);
+        return regressions;
+    }
+}
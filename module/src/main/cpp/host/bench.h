@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 极简基准框架：
+//   ns/op     重复执行 fn 直到累计 ~200ms 的平均耗时
+//   allocs/op 同一轮内 operator new 的调用次数（bench.cpp 替换了全局 operator new）
+//   p50/p99   以 16 次调用为一批采样的单次耗时分位数
+// 结果收集在 Results() 中，由 main 输出为 JSON 或与基线比较。
+namespace Bench {
+    struct Result {
+        std::string name;
+        double ns_per_op;
+        double allocs_per_op;
+        double p50_ns;
+        double p99_ns;
+    };
+
+    struct Options {
+        const char *filter = nullptr;     // 只运行名字包含该子串的用例
+        const char *json = nullptr;       // 结果写入该文件
+        const char *compare = nullptr;    // 与该基线文件比较
+        double threshold = 10.0;          // 比基线慢超过该百分比视为回退
+    };
+
+    Options &Opts();
+    std::vector<Result> &Results();
+    uint64_t Allocations();
+
+    bool Selected(const char *name);
+    void Record(Result result);
+
+    bool WriteJson(const char *path);
+    // 返回回退的用例数（基线不可读时返回 -1）
+    int Compare(const char *path, double thresholdPct);
+
+    // 阻止编译器把被测结果优化掉
+    template <typename T>
+    inline void DoNotOptimize(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    using Clock = std::chrono::steady_clock;
+
+    template <typename F>
+    inline double NsPerOp(F &&fn, uint64_t *itersOut = nullptr) {
+        uint64_t iters = 1024;
+        for (;;) {
+            auto begin = Clock::now();
+            for (uint64_t i = 0; i < iters; i++) fn();
+            auto ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+            if (ns >= 2e8 || iters >= (1ull << 32)) {
+                if (itersOut) *itersOut = iters;
+                return ns / double(iters);
+            }
+            iters *= ns < 2e7 ? 10 : 2;
+        }
+    }
+
+    // opsPerCall：fn 每次调用包含的操作数（批量用例按记录数折算）
+    template <typename F>
+    inline void Run(const char *name, F &&fn, uint64_t opsPerCall = 1) {
+        if (!Selected(name)) return;
+        constexpr int kBatch = 16;
+        constexpr int kSamples = 4096;
+
+        uint64_t iters = 0;
+        NsPerOp(fn, &iters);  // 预热并确定迭代次数
+
+        uint64_t allocs = Allocations();
+        auto begin = Clock::now();
+        for (uint64_t i = 0; i < iters; i++) fn();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+        allocs = Allocations() - allocs;
+
+        std::vector<double> samples(kSamples);
+        for (double &s : samples) {
+            auto t0 = Clock::now();
+            for (int i = 0; i < kBatch; i++) fn();
+            s = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / kBatch;
+        }
+        std::sort(samples.begin(), samples.end());
+
+        double ops = double(iters) * double(opsPerCall);
+        Record({name, ns / ops, double(allocs) / ops,
+                samples[kSamples / 2] / double(opsPerCall),
+                samples[kSamples * 99 / 100] / double(opsPerCall)});
+    }
+
+    // 每批调用 batch 次 fn 并计时，批与批之间执行不计时的 between（释放局部引用、写出日志缓冲区等）
+    template <typename F, typename B>
+    inline void RunBatched(const char *name, int batch, F &&fn, B &&between) {
+        if (!Selected(name)) return;
+        constexpr int kWarmup = 256;
+        constexpr int kRounds = 16384;
+
+        std::vector<double> samples(kRounds);
+        double total = 0;
+        uint64_t allocs = 0;
+        for (int round = -kWarmup; round < kRounds; round++) {
+            uint64_t a = Allocations();
+            auto t0 = Clock::now();
+            for (int i = 0; i < batch; i++) fn();
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+            if (round >= 0) {
+                allocs += Allocations() - a;
+                total += ns;
+                samples[round] = ns / batch;
+            }
+            between();
+        }
+        std::sort(samples.begin(), samples.end());
+        double ops = double(kRounds) * batch;
+        Record({name, total / ops, double(allocs) / ops, samples[kRounds / 2], samples[kRounds * 99 / 100]});
+    }
+}
@@ -0,0 +1,70 @@
+#include "bench.h"
+#include "device_hooks.h"
+#include "fake_jni_env.h"
+#include "jni_cache.h"
+#include "log.h"
+
+// Hook 处理函数在假 JNIEnv 上的单次调用开销（包括 LOGI 的格式化和追踪记录）。
+// 每批调用之间（不计时）Reset() 释放 hook 创建的局部引用，并写出日志缓冲区，
+// 这样测到的是日志入队的开销，而不是缓冲区满后的丢弃路径。
+static FakeJniEnv *g_env = nullptr;
+static jstring g_missKey = nullptr;
+static jstring g_sameLenKey = nullptr;
+static jstring g_bluetoothKey = nullptr;
+
+static jstring fakeGetSettingsString(JNIEnv *, jobject, jobject, jstring key) {
+    return key;
+}
+
+template <typename F>
+static void RunHook(const char *name, F &&fn) {
+    Bench::RunBatched(name, 32, fn, [] {
+        g_env->Reset();
+        AsyncLog::Drain();
+    });
+}
+
+void BenchHooks() {
+    FakeJniEnv env;
+    g_env = &env;
+    IdentitySnapshot::Get();
+    DeviceHooks::origGetSettingsString = fakeGetSettingsString;
+
+    // 键字符串设为全局引用，Reset() 不会释放
+    jstring androidIdKey = static_cast<jstring>(env.NewGlobalRef(env.MakeString("android_id")));
+    g_bluetoothKey = static_cast<jstring>(env.NewGlobalRef(env.MakeString("bluetooth_name")));
+    // 未命中路径：长度不在位图中 / 长度与 android_id 相同但内容不同
+    g_missKey = static_cast<jstring>(env.NewGlobalRef(env.MakeString("adb_enabled")));
+    g_sameLenKey = static_cast<jstring>(env.NewGlobalRef(env.MakeString("user_setup")));
+
+    RunHook("hook/GetDeviceId", [] { Bench::DoNotOptimize(DeviceHooks::hookGetDeviceId(g_env, nullptr)); });
+    RunHook("hook/GetImei", [] { Bench::DoNotOptimize(DeviceHooks::hookGetImei(g_env, nullptr, 0)); });
+    RunHook("hook/GetMacAddr", [] { Bench::DoNotOptimize(DeviceHooks::hookGetMacAddr(g_env, nullptr)); });
+    RunHook("hook/GetBssid", [] { Bench::DoNotOptimize(DeviceHooks::hookGetBssid(g_env, nullptr)); });
+    RunHook("hook/GetSettingsString/android_id", [androidIdKey] {
+        Bench::DoNotOptimize(DeviceHooks::hookGetSettingsString(g_env, nullptr, nullptr, androidIdKey));
+    });
+    RunHook("hook/GetSettingsString/bluetooth_name", [] {
+        Bench::DoNotOptimize(DeviceHooks::hookGetSettingsString(g_env, nullptr, nullptr, g_bluetoothKey));
+    });
+    RunHook("hook/GetSettingsString/miss", [] {
+        Bench::DoNotOptimize(DeviceHooks::hookGetSettingsString(g_env, nullptr, nullptr, g_missKey));
+    });
+    RunHook("hook/GetSettingsString/miss-samelen", [] {
+        Bench::DoNotOptimize(DeviceHooks::hookGetSettingsString(g_env, nullptr, nullptr, g_sameLenKey));
+    });
+    RunHook("hook/GetHardware", [] { Bench::DoNotOptimize(DeviceHooks::hookGetHardware()); });
+    RunHook("hook/GetLine1Number", [] { Bench::DoNotOptimize(DeviceHooks::hookGetLine1Number(g_env, nullptr)); });
+    RunHook("hook/GetSimSerial", [] { Bench::DoNotOptimize(DeviceHooks::hookGetSimSerial(g_env, nullptr)); });
+    RunHook("hook/GetSimOperator", [] { Bench::DoNotOptimize(DeviceHooks::hookGetSimOperator(g_env, nullptr)); });
+    RunHook("hook/GetMediaDrmUniqueId", [] {
+        Bench::DoNotOptimize(DeviceHooks::hookGetMediaDrmUniqueId(g_env, nullptr));
+    });
+
+    JniCache::Release(&env);
+    env.DeleteGlobalRef(androidIdKey);
+    env.DeleteGlobalRef(g_bluetoothKey);
+    env.DeleteGlobalRef(g_missKey);
+    env.DeleteGlobalRef(g_sameLenKey);
+    g_env = nullptr;
+}
@@ -0,0 +1,115 @@
+#include <cstdio>
+#include "bench.h"
+#include "device_hooks.h"
+#include "fake_jni_env.h"
+#include "jni_cache.h"
+#include "jni_rebind.h"
+#include "log.h"
+
+// JNI 重绑定：在 FakeJniEnv 上模拟 Zygisk 的 hookJniNativeMethods，
+// 测量整表重绑定的开销，以及经由重绑定后的 native 入口调用各 handler 的开销。
+static FakeJniEnv *g_env = nullptr;
+static jstring g_hardwareKey = nullptr;
+static jstring g_missKey = nullptr;
+static jstring g_drmKey = nullptr;
+static jstring g_drmMissKey = nullptr;
+// 重绑定后类中登记的 native 入口，相当于 ART 调用 native 方法时读取的函数指针
+static DeviceHooks::SysPropGetFunc g_nativeGet = nullptr;
+static DeviceHooks::MediaDrmGetPropertyFunc g_getPropertyByteArray = nullptr;
+
+static jstring fakeNativeGet(JNIEnv *, jclass, jstring, jstring def) {
+    return def;
+}
+
+static jbyteArray fakeGetPropertyByteArray(JNIEnv *env, jobject, jstring) {
+    return env->NewByteArray(0);
+}
+
+// 与 Zygisk 相同的语义：已注册的方法换成新指针并把原指针写回 fnPtr，否则 fnPtr 置空
+static void HostHookNatives(void *, JNIEnv *env, const char *clazz, JNINativeMethod *methods, int count) {
+    auto *fake = static_cast<FakeJniEnv *>(env);
+    JNINativeMethod found[JniTable::kMaxPerClass];
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        const FakeJniEnv::Method *m = fake->FindMethod(clazz, methods[i].name, methods[i].signature);
+        void *orig = m != nullptr ? m->fnPtr : nullptr;
+        if (orig != nullptr) found[n++] = methods[i];
+        methods[i].fnPtr = orig;
+    }
+    if (n == 0) return;
+    jclass cls = env->FindClass(clazz);
+    env->RegisterNatives(cls, found, n);
+}
+
+template <typename F>
+static void RunHook(const char *name, F &&fn) {
+    Bench::RunBatched(name, 32, fn, [] {
+        g_env->Reset();
+        AsyncLog::Drain();
+    });
+}
+
+void BenchJni() {
+    FakeJniEnv env;
+    g_env = &env;
+    IdentitySnapshot::Get();
+
+    env.DefineClass("android/os/SystemProperties", {
+            {"native_get", "(Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;", true,
+             reinterpret_cast<void *>(fakeNativeGet)},
+    });
+    env.DefineClass("android/media/MediaDrm", {
+            {"getPropertyByteArray", "(Ljava/lang/String;)[B", false, reinterpret_cast<void *>(fakeGetPropertyByteArray)},
+    });
+
+    // 首次重绑定（含 FindClass / GetMethodID），随后检查替换结果
+    JniRebind::Result result;
+    JniRebind::Rebind(&env, HostHookNatives, nullptr, result);
+    for (size_t i = 0; i < JniTable::kCount; i++) {
+        const JniTable::Method &m = JniTable::kMethods[i];
+        const FakeJniEnv::Method *bound = env.FindMethod(m.clazz, m.name, m.signature);
+        if (result.status[i] != JniRebind::Status::Rebound || bound->fnPtr != DeviceHooks::kJniBindings[i].handler) {
+            fprintf(stderr, "jni rebind failed for %s: %s\n", m.name, JniRebind::StatusName(result.status[i]));
+        }
+    }
+
+    // 类与方法 ID 已缓存：重复重绑定只剩每类一次 hook 调用
+    Bench::Run("jni/Rebind", [] {
+        JniRebind::Result r;
+        JniRebind::Rebind(g_env, HostHookNatives, nullptr, r);
+        Bench::DoNotOptimize(r);
+    }, JniTable::kCount);
+    if (DeviceHooks::origSysPropGet != fakeNativeGet) fprintf(stderr, "jni rebind clobbered orig pointer\n");
+
+    g_hardwareKey = static_cast<jstring>(env.NewGlobalRef(env.MakeString("ro.hardware")));
+    g_missKey = static_cast<jstring>(env.NewGlobalRef(env.MakeString("ro.build.version.sdk")));
+    g_drmKey = static_cast<jstring>(env.NewGlobalRef(env.MakeString("deviceUniqueId")));
+    g_drmMissKey = static_cast<jstring>(env.NewGlobalRef(env.MakeString("securityLevel")));
+
+    g_nativeGet = reinterpret_cast<DeviceHooks::SysPropGetFunc>(
+            env.FindMethod("android/os/SystemProperties", "native_get",
+                           "(Ljava/lang/String;Ljava/lang/String;)Ljava/lang/String;")->fnPtr);
+    g_getPropertyByteArray = reinterpret_cast<DeviceHooks::MediaDrmGetPropertyFunc>(
+            env.FindMethod("android/media/MediaDrm", "getPropertyByteArray", "(Ljava/lang/String;)[B")->fnPtr);
+
+    RunHook("jni/SysPropGet/ro.hardware", [] {
+        Bench::DoNotOptimize(g_nativeGet(g_env, nullptr, g_hardwareKey, nullptr));
+    });
+    RunHook("jni/SysPropGet/miss", [] {
+        Bench::DoNotOptimize(g_nativeGet(g_env, nullptr, g_missKey, nullptr));
+    });
+    RunHook("jni/MediaDrmGetProperty/deviceUniqueId", [] {
+        Bench::DoNotOptimize(g_getPropertyByteArray(g_env, nullptr, g_drmKey));
+    });
+    RunHook("jni/MediaDrmGetProperty/miss", [] {
+        Bench::DoNotOptimize(g_getPropertyByteArray(g_env, nullptr, g_drmMissKey));
+    });
+
+    JniCache::Release(&env);
+    JniRebind::Release(&env);
+    env.DeleteGlobalRef(g_hardwareKey);
+    env.DeleteGlobalRef(g_missKey);
+    env.DeleteGlobalRef(g_drmKey);
+    env.DeleteGlobalRef(g_drmMissKey);
+    g_env = nullptr;
+}
@@ -0,0 +1,19 @@
+#include "bench.h"
+#include "log.h"
+
+// 同步 __android_log_print 与异步环形缓冲区的单条日志开销（后者启动写出线程后测量）
+void BenchLog() {
+    static const char *imei = "861234567890123";
+    Bench::Run("log/sync", [] {
+        __android_log_print(ANDROID_LOG_INFO, LOG_TAG, "Return random IMEI: %s", imei);
+    });
+    AsyncLog::Start();
+    // 批间写出缓冲区：入队开销（含格式化）
+    Bench::RunBatched("log/async", 32, [] {
+        AsyncLog::Write(ANDROID_LOG_INFO, "Return random IMEI: %s", imei);
+    }, [] { AsyncLog::Drain(); });
+    // 不写出：缓冲区满后的丢弃路径
+    Bench::Run("log/async-full", [] {
+        AsyncLog::Write(ANDROID_LOG_INFO, "Return random IMEI: %s", imei);
+    });
+}
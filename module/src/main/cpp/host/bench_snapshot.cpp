@@ -0,0 +1,106 @@
+#include "bench.h"
+#include "identity_snapshot.h"
+#include "zygisk_device_random.h"
+#include <set>
+#include <string>
+#include <thread>
+
+// 256 线程压力测试：旧实现每个Hook各有一个 static thread_local std::string 缓存，
+// 对照进程级快照。统计每线程首次调用耗时、稳态单次耗时、每线程堆分配次数，以及各线程看到的不同 IMEI 个数。
+namespace {
+    constexpr int kThreads = 256;
+    constexpr int kCallsPerThread = 20000;
+
+    struct TlsCache {
+        static const char *Imei() {
+            static thread_local std::string cache = RandUtil::IMEI();
+            return cache.c_str();
+        }
+        static const char *Mac() {
+            static thread_local std::string cache = RandUtil::MAC();
+            return cache.c_str();
+        }
+        static const char *AndroidId() {
+            static thread_local std::string cache = RandUtil::Hex(16);
+            return cache.c_str();
+        }
+        static const char *MediaDrmId() {
+            static thread_local std::string cache = RandUtil::MediaDrmID();
+            return cache.c_str();
+        }
+    };
+
+    struct Snapshot {
+        static const char *Imei() { return IdentitySnapshot::Get().imei; }
+        static const char *Mac() { return IdentitySnapshot::Get().mac; }
+        static const char *AndroidId() { return IdentitySnapshot::Get().android_id; }
+        static const char *MediaDrmId() { return IdentitySnapshot::Get().media_drm_id; }
+    };
+
+    struct ThreadStats {
+        double first_ns;
+        double steady_ns;
+        std::string imei;
+    };
+
+    template <typename Source>
+    void Stress(const char *mode) {
+        std::string firstName = std::string("stress256/") + mode + "/first-call";
+        std::string steadyName = std::string("stress256/") + mode + "/steady";
+        if (!Bench::Selected(firstName.c_str()) && !Bench::Selected(steadyName.c_str())) return;
+
+        std::vector<ThreadStats> stats(kThreads);
+        for (auto &s : stats) s.imei.reserve(RandUtil::kImeiLen);
+        uint64_t allocs = Bench::Allocations();
+        std::vector<std::thread> pool;
+        pool.reserve(kThreads);
+        for (int t = 0; t < kThreads; t++) {
+            pool.emplace_back([&stats, t] {
+                ThreadStats &s = stats[t];
+                auto t0 = Bench::Clock::now();
+                Bench::DoNotOptimize(Source::Imei());
+                Bench::DoNotOptimize(Source::Mac());
+                Bench::DoNotOptimize(Source::AndroidId());
+                Bench::DoNotOptimize(Source::MediaDrmId());
+                auto t1 = Bench::Clock::now();
+                for (int i = 0; i < kCallsPerThread; i++) {
+                    Bench::DoNotOptimize(Source::Imei());
+                    Bench::DoNotOptimize(Source::Mac());
+                    Bench::DoNotOptimize(Source::AndroidId());
+                    Bench::DoNotOptimize(Source::MediaDrmId());
+                }
+                auto t2 = Bench::Clock::now();
+                s.first_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / 4;
+                s.steady_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / (4.0 * kCallsPerThread);
+                s.imei.assign(Source::Imei());
+            });
+        }
+        for (auto &th : pool) th.join();
+        // 减去 std::thread 自身的分配，只保留缓存带来的部分
+        double perThread = double(Bench::Allocations() - allocs) / kThreads - 1;
+
+        std::vector<double> first, steady;
+        std::set<std::string> distinct;
+        for (const auto &s : stats) {
+            first.push_back(s.first_ns);
+            steady.push_back(s.steady_ns);
+            distinct.insert(s.imei);
+        }
+        std::sort(first.begin(), first.end());
+        std::sort(steady.begin(), steady.end());
+        auto mean = [](const std::vector<double> &v) {
+            double sum = 0;
+            for (double x : v) sum += x;
+            return sum / double(v.size());
+        };
+        Bench::Record({firstName, mean(first), perThread, first[kThreads / 2], first[kThreads * 99 / 100]});
+        Bench::Record({steadyName, mean(steady), 0, steady[kThreads / 2], steady[kThreads * 99 / 100]});
+        std::printf("%-36s %zu distinct IMEI across %d threads\n", mode, distinct.size(), kThreads);
+    }
+}
+
+void BenchSnapshot() {
+    IdentitySnapshot::Get();
+    Stress<TlsCache>("tls-string");
+    Stress<Snapshot>("snapshot");
+}
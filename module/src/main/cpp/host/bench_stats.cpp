@@ -0,0 +1,24 @@
+#include "bench.h"
+#include "hook_stats.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+// 在临时目录中打开统计文件（之后的 hook/* 用例同样计入），测量常驻统计的开销：
+//   stats/clock   单次 CycleClock::Now()
+//   stats/record  一次 Record（三次 relaxed fetch_add）
+//   stats/timer   空作用域计时器 = 两次取时钟 + Record，即每个Hook增加的开销
+void BenchStats() {
+    char dir[] = "/tmp/randomid-bench-XXXXXX";
+    if (mkdtemp(dir) == nullptr) return;
+    int dirfd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    bool opened = HookStats::Open(dirfd, "bench");
+    if (dirfd >= 0) close(dirfd);
+    if (!opened) return;
+    std::printf("%-36s %s/traces/bench.stats\n", "stats file", dir);
+
+    Bench::Run("stats/clock", [] { Bench::DoNotOptimize(CycleClock::Now()); });
+    static uint64_t ticks = 0;
+    Bench::Run("stats/record", [] { HookStats::Record(HookId::GetImei, ticks++ & 1023); });
+    Bench::Run("stats/timer", [] { HookStats::Timer timer(HookId::GetDeviceId); });
+}
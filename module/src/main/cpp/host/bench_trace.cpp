@@ -0,0 +1,21 @@
+#include "bench.h"
+#include "hook_trace.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+// 在临时目录中打开追踪文件（之后的 hook/* 用例同样写入追踪），测量单条记录的追加开销
+void BenchTrace() {
+    char dir[] = "/tmp/randomid-bench-XXXXXX";
+    if (mkdtemp(dir) == nullptr) return;
+    int dirfd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    bool opened = HookTrace::Open(dirfd, "bench");
+    if (dirfd >= 0) close(dirfd);
+    if (!opened) return;
+    std::printf("%-36s %s/traces/bench.trace\n", "trace file", dir);
+
+    static const char *imei = "861234567890123";
+    Bench::Run("trace/emit", [] {
+        TRACE_HOOK(ReturnImei, imei, 0);
+    });
+}
@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <link.h>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "bench.h"
+#include "xdl.h"
+#include "xdl/xdl_lzma.h"
+
+// xdl.c 在定义了 XDL_HOST_BENCH 时导出（见 host/CMakeLists.txt）
+extern "C" int xdl_symtab_force_heap;
+
+// xdl_addr 符号化：在一个大 ELF 的可执行段里取 1M 个随机 PC 逐个查询；
+// xdl_dsym 按名字查 .symtab：名字取自上述 PC 符号化的结果；
+// xdl/symtab/load/{mmap,heap} 是 xdl_open + 首次 xdl_dsym（读入 .symtab 并建名字索引）+ xdl_close 的耗时，
+// 分别走映射文件与堆拷贝两条路径；另外按路径输出一个 handle 持有 .symtab 期间的 RSS 增量（匿名页 / 文件页分开）。
+// 库带 .gnu_debugdata（MiniDebugInfo）时，xdl/symtab/load 走的是解压路径；另有 xdl/lzma/decompress 单独测解压，
+// 宿主机有 liblzma.so.5 时用 xdl/lzma/liblzma 作对照。
+// xdl/symtab/cached 是同一个库在 xdl_set_cache_dir() 之后的加载耗时：首次解压并写出缓存文件（单独打印），
+// 之后每次只映射缓存；用例结束前核对开关缓存时 xdl_dsym / xdl_addr 的结果一致。
+// 运行用例前先用 randomid_xdl_fixture 检查重叠符号的解析结果（同一起点取最内层，同长度别名取 .dynsym 中靠前者）。
+// 默认用 libstdc++.so.6；RANDOMID_BENCH_ELF 可以换成更大的库（例如带 .symtab 的 libpython / 游戏引擎 .so）。
+namespace {
+    constexpr size_t kPcs = 1 << 20;
+    constexpr size_t kNames = 4096;
+
+    struct Target {
+        const char *name;
+        std::vector<uintptr_t> pcs;
+    };
+
+    // /proc/self/status 中的 RssAnon / RssFile，单位 kB
+    void ReadRss(long &anon, long &file) {
+        anon = file = 0;
+        FILE *fp = fopen("/proc/self/status", "re");
+        if (fp == nullptr) return;
+        char line[128];
+        while (fgets(line, sizeof(line), fp) != nullptr) {
+            sscanf(line, "RssAnon: %ld", &anon);
+            sscanf(line, "RssFile: %ld", &file);
+        }
+        fclose(fp);
+    }
+
+    // 单次耗时在毫秒级的用例：固定跑 rounds 次取分位数
+    template <typename F>
+    void RunRounds(const char *name, int rounds, F &&fn) {
+        std::vector<double> samples(static_cast<size_t>(rounds));
+        for (double &ns : samples) {
+            auto t0 = Bench::Clock::now();
+            fn();
+            ns = std::chrono::duration<double, std::nano>(Bench::Clock::now() - t0).count();
+        }
+        double total = 0;
+        for (double ns : samples) total += ns;
+        std::sort(samples.begin(), samples.end());
+        Bench::Record({name, total / rounds, 0, samples[size_t(rounds) / 2], samples[size_t(rounds) * 99 / 100]});
+    }
+
+    // 一个 handle 持有 .symtab 期间的 RSS 增量。每种路径在单独 fork 出的子进程里量：
+    // 前一种路径释放的堆页会被后一种复用，同一进程里先后量会低估后者
+    void PrintSymtabRss(const char *name, const char *path) {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid < 0) return;
+        if (pid == 0) {
+            long anon0, file0, anon1, file1;
+            ReadRss(anon0, file0);
+            void *handle = xdl_open(name, XDL_DEFAULT);
+            if (handle != nullptr) {
+                xdl_dsym(handle, "", nullptr);
+                ReadRss(anon1, file1);
+                fprintf(stderr, "xdl bench: .symtab of %s (%s) resident +%ld kB anon, +%ld kB file\n", name, path,
+                        anon1 - anon0, file1 - file0);
+            }
+            _exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+    }
+
+    void BenchSymtabLoad(const char *name) {
+        if (!Bench::Selected("xdl/symtab/load")) return;
+
+        // mmap 是默认路径；xdl_symtab_force_heap 让 xdl_symtab_load 改用 xdl_read_file_to_heap_by_section 拷贝。
+        // 没有 .symtab 的库（已 strip、或只有 .gnu_debugdata）两行应当相同
+        static const struct {
+            const char *path;
+            int force_heap;
+        } kPaths[] = {{"mmap", 0}, {"heap", 1}};
+        for (const auto &mode : kPaths) {
+            xdl_symtab_force_heap = mode.force_heap;
+            PrintSymtabRss(name, mode.path);
+        }
+        for (const auto &mode : kPaths) {
+            xdl_symtab_force_heap = mode.force_heap;
+            // 每次都是新 handle，整体加载一遍；页缓存是热的
+            std::string label = std::string("xdl/symtab/load/") + mode.path;
+            RunRounds(label.c_str(), 32, [name] {
+                void *h = xdl_open(name, XDL_DEFAULT);
+                Bench::DoNotOptimize(xdl_dsym(h, "", nullptr));
+                xdl_close(h);
+            });
+        }
+        xdl_symtab_force_heap = 0;
+    }
+
+    // MiniDebugInfo 缓存目录，没有写出缓存文件时为 -1
+    int s_cacheDir = -1;
+
+    size_t CacheFileSize(const char *dir) {
+        size_t size = 0;
+        DIR *d = opendir(dir);
+        if (d == nullptr) return 0;
+        for (dirent *ent; (ent = readdir(d)) != nullptr;) {
+            struct stat st;
+            if (strncmp(ent->d_name, "xdl-", 4) == 0 && fstatat(dirfd(d), ent->d_name, &st, 0) == 0) {
+                size += size_t(st.st_size);
+            }
+        }
+        closedir(d);
+        return size;
+    }
+
+    void BenchSymtabCache(const char *name) {
+        if (!Bench::Selected("xdl/symtab/cached")) return;
+        char dir[] = "/tmp/randomid-bench-XXXXXX";
+        if (mkdtemp(dir) == nullptr) return;
+        int fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) return;
+        xdl_set_cache_dir(fd);
+
+        // 首次：解压、建索引并写出缓存文件
+        auto t0 = Bench::Clock::now();
+        void *handle = xdl_open(name, XDL_DEFAULT);
+        if (handle != nullptr) xdl_dsym(handle, "", nullptr);
+        double coldMs = std::chrono::duration<double, std::milli>(Bench::Clock::now() - t0).count();
+        if (handle != nullptr) xdl_close(handle);
+        size_t size = CacheFileSize(dir);
+        if (size == 0) {
+            // 带 .symtab 或没有 build-id 的库不写缓存
+            fprintf(stderr, "xdl bench: no symbol cache written for %s\n", name);
+            xdl_set_cache_dir(-1);
+            close(fd);
+            return;
+        }
+        fprintf(stderr, "xdl bench: symbol cache of %s written in %.3f ms, %zu bytes in %s\n", name, coldMs, size, dir);
+
+        long anon0, file0, anon1, file1;
+        ReadRss(anon0, file0);
+        handle = xdl_open(name, XDL_DEFAULT);
+        xdl_dsym(handle, "", nullptr);
+        ReadRss(anon1, file1);
+        xdl_close(handle);
+        fprintf(stderr, "xdl bench: cached .symtab of %s resident +%ld kB anon, +%ld kB file\n", name, anon1 - anon0,
+                file1 - file0);
+
+        RunRounds("xdl/symtab/cached", 32, [name] {
+            void *h = xdl_open(name, XDL_DEFAULT);
+            Bench::DoNotOptimize(xdl_dsym(h, "", nullptr));
+            xdl_close(h);
+        });
+        // 其余用例不走缓存，最后再用它核对结果
+        xdl_set_cache_dir(-1);
+        s_cacheDir = fd;
+    }
+
+    // 开关缓存各查一遍，符号必须一致
+    void VerifySymtabCache(const char *name, const std::vector<std::string> &names, const std::vector<uintptr_t> &pcs) {
+        if (s_cacheDir < 0) return;
+        void *plain = xdl_open(name, XDL_DEFAULT);
+        xdl_set_cache_dir(s_cacheDir);
+        void *cached = xdl_open(name, XDL_DEFAULT);
+        size_t diff = 0;
+        for (const std::string &n : names) {
+            diff += xdl_dsym(plain, n.c_str(), nullptr) != xdl_dsym(cached, n.c_str(), nullptr);
+        }
+        xdl_close(cached);
+
+        std::vector<const void *> expect;
+        void *cache = nullptr;
+        for (size_t i = 0; i < pcs.size(); i += 16) {
+            xdl_info_t info;
+            expect.push_back(xdl_addr(reinterpret_cast<void *>(pcs[i]), &info, &cache) != 0 ? info.dli_saddr : nullptr);
+        }
+        xdl_addr_clean(&cache);
+        xdl_set_cache_dir(-1);
+        for (size_t i = 0; i < pcs.size(); i += 16) {
+            xdl_info_t info;
+            diff += expect[i / 16] != (xdl_addr(reinterpret_cast<void *>(pcs[i]), &info, &cache) != 0 ? info.dli_saddr : nullptr);
+        }
+        xdl_addr_clean(&cache);
+        xdl_close(plain);
+        fprintf(stderr, "xdl bench: symbol cache checked against %zu names and %zu PCs, %zu differ\n", names.size(),
+                expect.size(), diff);
+        close(s_cacheDir);
+        s_cacheDir = -1;
+    }
+
+    // 从文件中取出 .gnu_debugdata 的内容
+    bool ReadDebugData(const char *path, std::vector<uint8_t> &out) {
+        FILE *fp = fopen(path, "rbe");
+        if (fp == nullptr) return false;
+        std::vector<uint8_t> file;
+        uint8_t chunk[1 << 16];
+        for (size_t n; (n = fread(chunk, 1, sizeof(chunk), fp)) > 0;) file.insert(file.end(), chunk, chunk + n);
+        fclose(fp);
+
+        if (file.size() < sizeof(ElfW(Ehdr))) return false;
+        auto *ehdr = reinterpret_cast<const ElfW(Ehdr) *>(file.data());
+        if (ehdr->e_shentsize != sizeof(ElfW(Shdr)) || ehdr->e_shstrndx >= ehdr->e_shnum ||
+            ehdr->e_shoff + size_t(ehdr->e_shnum) * sizeof(ElfW(Shdr)) > file.size()) {
+            return false;
+        }
+        auto *shdrs = reinterpret_cast<const ElfW(Shdr) *>(file.data() + ehdr->e_shoff);
+        const ElfW(Shdr) &shstrtab = shdrs[ehdr->e_shstrndx];
+        for (size_t i = 0; i < ehdr->e_shnum; i++) {
+            const ElfW(Shdr) &shdr = shdrs[i];
+            if (shstrtab.sh_offset + shdr.sh_name >= file.size() || shdr.sh_offset + shdr.sh_size > file.size()) continue;
+            if (strcmp(reinterpret_cast<const char *>(file.data() + shstrtab.sh_offset + shdr.sh_name),
+                       ".gnu_debugdata") != 0) {
+                continue;
+            }
+            out.assign(file.begin() + long(shdr.sh_offset), file.begin() + long(shdr.sh_offset + shdr.sh_size));
+            return true;
+        }
+        return false;
+    }
+
+    // liblzma 的 lzma_stream_buffer_decode，只用作对照
+    using LzmaBufferDecode = int (*)(uint64_t *memlimit, uint32_t flags, const void *allocator, const uint8_t *in,
+                                     size_t *in_pos, size_t in_size, uint8_t *out, size_t *out_pos, size_t out_size);
+
+    void BenchLzma(const char *path) {
+        if (!Bench::Selected("xdl/lzma/")) return;
+        static std::vector<uint8_t> zipped;
+        if (!ReadDebugData(path, zipped)) return;
+
+        static size_t size = 0;
+        uint8_t *out = nullptr;
+        if (xdl_lzma_decompress(zipped.data(), zipped.size(), &out, &size) != 0) {
+            fprintf(stderr, "xdl bench: cannot decompress .gnu_debugdata of %s\n", path);
+            return;
+        }
+        fprintf(stderr, "xdl bench: .gnu_debugdata of %s: %zu -> %zu bytes\n", path, zipped.size(), size);
+
+        RunRounds("xdl/lzma/decompress", 16, [] {
+            uint8_t *buf = nullptr;
+            size_t n = 0;
+            xdl_lzma_decompress(zipped.data(), zipped.size(), &buf, &n);
+            Bench::DoNotOptimize(buf);
+            free(buf);
+        });
+
+        void *lzma = dlopen("liblzma.so.5", RTLD_NOW | RTLD_LOCAL);
+        static LzmaBufferDecode decode = nullptr;
+        if (lzma != nullptr) decode = reinterpret_cast<LzmaBufferDecode>(dlsym(lzma, "lzma_stream_buffer_decode"));
+        if (decode != nullptr) {
+            static std::vector<uint8_t> ref(size);
+            size_t inPos = 0, outPos = 0;
+            uint64_t memlimit = UINT64_MAX;
+            int ret = decode(&memlimit, 0, nullptr, zipped.data(), &inPos, zipped.size(), ref.data(), &outPos, size);
+            if (ret != 0 || outPos != size || memcmp(ref.data(), out, size) != 0) {
+                fprintf(stderr, "xdl bench: output differs from liblzma (ret %d)\n", ret);
+            }
+            RunRounds("xdl/lzma/liblzma", 16, [] {
+                // 与 xdl 一致：每次都分配输出缓冲区
+                auto *buf = static_cast<uint8_t *>(malloc(size));
+                size_t inPos = 0, outPos = 0;
+                uint64_t memlimit = UINT64_MAX;
+                Bench::DoNotOptimize(decode(&memlimit, 0, nullptr, zipped.data(), &inPos, zipped.size(), buf, &outPos, size));
+                free(buf);
+            });
+            ref.clear();
+            ref.shrink_to_fit();
+        }
+        if (lzma != nullptr) dlclose(lzma);
+        free(out);
+        zipped.clear();
+        zipped.shrink_to_fit();
+    }
+
+    // fixture 的两个同起点、同长度别名中 .dynsym 序号较小的一个（逐个扫描 .dynsym 时先命中的那个）
+    int FindFirstAlias(struct dl_phdr_info *info, size_t, void *arg) {
+        if (info->dlpi_name == nullptr || strstr(info->dlpi_name, "randomid_xdl_fixture") == nullptr) return 0;
+        const ElfW(Dyn) *dyn = nullptr;
+        for (size_t i = 0; i < info->dlpi_phnum; i++) {
+            if (info->dlpi_phdr[i].p_type == PT_DYNAMIC) {
+                dyn = reinterpret_cast<const ElfW(Dyn) *>(info->dlpi_addr + info->dlpi_phdr[i].p_vaddr);
+            }
+        }
+        const ElfW(Sym) *syms = nullptr;
+        const char *strs = nullptr;
+        const uint32_t *hash = nullptr;
+        // glibc 已把 .dynamic 中的地址改写为绝对地址
+        for (; dyn != nullptr && dyn->d_tag != DT_NULL; dyn++) {
+            if (dyn->d_tag == DT_SYMTAB) syms = reinterpret_cast<const ElfW(Sym) *>(dyn->d_un.d_ptr);
+            if (dyn->d_tag == DT_STRTAB) strs = reinterpret_cast<const char *>(dyn->d_un.d_ptr);
+            if (dyn->d_tag == DT_HASH) hash = reinterpret_cast<const uint32_t *>(dyn->d_un.d_ptr);
+        }
+        if (syms == nullptr || strs == nullptr || hash == nullptr) return 1;
+        for (uint32_t i = 0; i < hash[1]; i++) {
+            const char *name = strs + syms[i].st_name;
+            if (strcmp(name, "xdl_fixture_inner") == 0 || strcmp(name, "xdl_fixture_inner_alias") == 0) {
+                *static_cast<const char **>(arg) = name;
+                return 1;
+            }
+        }
+        return 1;
+    }
+
+    void CheckOverlap() {
+        void *dl = dlopen(RANDOMID_XDL_FIXTURE, RTLD_NOW | RTLD_LOCAL);
+        if (dl == nullptr) {
+            fprintf(stderr, "xdl check: cannot load %s\n", RANDOMID_XDL_FIXTURE);
+            return;
+        }
+        auto *base = static_cast<const char *>(dlsym(dl, "xdl_fixture_outer"));
+        static const char *alias = nullptr;
+        dl_iterate_phdr(FindFirstAlias, &alias);
+        static const size_t kOffsets[] = {0, 4, 7, 8, 15, 16, 19, 20, 31};
+        auto expected = [](size_t offset) -> const char * {
+            if (offset < 8) return alias;
+            if (offset >= 16 && offset < 20) return "xdl_fixture_nested";
+            return "xdl_fixture_outer";
+        };
+
+        // 顺序、逆序各查一遍，并且每个地址连查两次，覆盖二分查找与 last_hit 两条路径
+        size_t bad = 0;
+        void *cache = nullptr;
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t k = 0; k < std::size(kOffsets); k++) {
+                size_t offset = kOffsets[pass == 0 ? k : std::size(kOffsets) - 1 - k];
+                for (int repeat = 0; repeat < 2; repeat++) {
+                    xdl_info_t info;
+                    const char *got = xdl_addr(const_cast<char *>(base + offset), &info, &cache) != 0 ? info.dli_sname
+                                                                                                      : nullptr;
+                    const char *want = expected(offset);
+                    if (got == nullptr || want == nullptr || strcmp(got, want) != 0) {
+                        fprintf(stderr, "xdl check: +%zu resolved to %s, expected %s\n", offset, got ? got : "(null)",
+                                want ? want : "(null)");
+                        bad++;
+                    }
+                }
+            }
+        }
+        xdl_addr_clean(&cache);
+        dlclose(dl);
+        fprintf(stderr, "xdl check: overlapping symbols %s\n", bad == 0 ? "resolved innermost-first" : "MISMATCH");
+    }
+
+    int CollectPcs(struct dl_phdr_info *info, size_t, void *arg) {
+        auto &target = *static_cast<Target *>(arg);
+        if (info->dlpi_name == nullptr || strstr(info->dlpi_name, target.name) == nullptr) return 0;
+        std::vector<std::pair<uintptr_t, uintptr_t>> text;
+        uintptr_t total = 0;
+        for (size_t i = 0; i < info->dlpi_phnum; i++) {
+            const ElfW(Phdr) &phdr = info->dlpi_phdr[i];
+            if (phdr.p_type != PT_LOAD || (phdr.p_flags & PF_X) == 0) continue;
+            text.emplace_back(info->dlpi_addr + phdr.p_vaddr, phdr.p_memsz);
+            total += phdr.p_memsz;
+        }
+        if (total == 0) return 0;
+        std::mt19937_64 rng(42);
+        target.pcs.resize(kPcs);
+        for (uintptr_t &pc : target.pcs) {
+            uintptr_t off = rng() % total;
+            for (const auto &seg : text) {
+                if (off < seg.second) {
+                    pc = seg.first + off;
+                    break;
+                }
+                off -= seg.second;
+            }
+        }
+        return 1;
+    }
+}
+
+void BenchXdl() {
+    if (!Bench::Selected("xdl/")) return;
+    CheckOverlap();
+    const char *name = getenv("RANDOMID_BENCH_ELF");
+    if (name == nullptr || *name == '\0') name = "libstdc++.so.6";
+    void *dl = dlopen(name, RTLD_NOW | RTLD_LOCAL);
+    if (dl == nullptr) {
+        fprintf(stderr, "xdl bench: cannot load %s\n", name);
+        return;
+    }
+    // 先于其它用例运行，堆里还没有可复用的空闲页，RSS 增量才准确
+    BenchSymtabLoad(name);
+    BenchSymtabCache(name);
+    BenchLzma(name);
+
+    static Target target;
+    target.name = strrchr(name, '/') != nullptr ? strrchr(name, '/') + 1 : name;
+    dl_iterate_phdr(CollectPcs, &target);
+    if (target.pcs.empty()) {
+        fprintf(stderr, "xdl bench: no executable segment in %s\n", name);
+        dlclose(dl);
+        return;
+    }
+    fprintf(stderr, "xdl bench: %zu random PCs in %s\n", target.pcs.size(), name);
+
+    // 随机 PC：每次都是二分查找
+    static void *cache = nullptr;
+    static size_t next = 0;
+    Bench::Run("xdl/addr/random", [] {
+        xdl_info_t info;
+        xdl_addr(reinterpret_cast<void *>(target.pcs[next++ & (kPcs - 1)]), &info, &cache);
+        Bench::DoNotOptimize(info.dli_sname);
+    });
+
+    // 同一个函数内连续的 PC（栈回溯里的相邻帧、采样分析的热点）：命中上一次的结果
+    Bench::Run("xdl/addr/nearby", [] {
+        size_t i = next++;
+        uintptr_t pc = target.pcs[(i >> 6) & (kPcs - 1)] + (i & 63) * 4;
+        xdl_info_t info;
+        xdl_addr(reinterpret_cast<void *>(pc), &info, &cache);
+        Bench::DoNotOptimize(info.dli_sname);
+    });
+
+    // 收集一批不重复的符号名，handle 关闭前拷贝出来
+    static std::vector<std::string> names;
+    for (size_t i = 0; i < kPcs && names.size() < kNames; i += 7) {
+        xdl_info_t info;
+        if (xdl_addr(reinterpret_cast<void *>(target.pcs[i]), &info, &cache) == 0 || info.dli_sname == nullptr) continue;
+        if (names.empty() || names.back() != info.dli_sname) names.emplace_back(info.dli_sname);
+    }
+    xdl_addr_clean(&cache);
+
+    static void *handle = xdl_open(name, XDL_DEFAULT);
+    if (handle != nullptr && !names.empty()) {
+        size_t missing = 0;
+        for (const std::string &n : names) missing += xdl_dsym(handle, n.c_str(), nullptr) == nullptr;
+        if (missing > 0) fprintf(stderr, "xdl bench: %zu of %zu names not found by xdl_dsym\n", missing, names.size());
+        // 没有 .symtab（已 strip）的库只剩缺失路径，没有意义
+        if (missing < names.size()) {
+            Bench::Run("xdl/dsym", [] {
+                Bench::DoNotOptimize(xdl_dsym(handle, names[next++ % names.size()].c_str(), nullptr));
+            });
+        }
+    }
+    if (handle != nullptr) xdl_close(handle);
+    VerifySymtabCache(name, names, target.pcs);
+    names.clear();
+    names.shrink_to_fit();
+
+    target.pcs.clear();
+    target.pcs.shrink_to_fit();
+    dlclose(dl);
+}
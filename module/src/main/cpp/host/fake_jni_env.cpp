@@ -0,0 +1,199 @@
+#include "fake_jni_env.h"
+#include <cstring>
+
+struct FakeJniEnv::Object {
+    virtual ~Object() = default;
+    virtual _jobject *Handle() = 0;
+};
+
+struct FakeJniEnv::String : _jstring, Object {
+    std::u16string chars;
+    _jobject *Handle() override { return this; }
+};
+
+struct FakeJniEnv::ByteArray : _jbyteArray, Object {
+    std::vector<jbyte> data;
+    _jobject *Handle() override { return this; }
+};
+
+struct FakeJniEnv::Class : _jclass, Object {
+    std::string name;
+    std::vector<Method> methods;
+    _jobject *Handle() override { return this; }
+};
+
+FakeJniEnv::String *FakeJniEnv::AsString(jstring str) { return static_cast<String *>(str); }
+FakeJniEnv::ByteArray *FakeJniEnv::AsArray(jarray array) { return static_cast<ByteArray *>(static_cast<_jbyteArray *>(array)); }
+FakeJniEnv::Class *FakeJniEnv::AsClass(jclass clazz) { return static_cast<Class *>(clazz); }
+
+template <typename T>
+T *FakeJniEnv::Adopt(std::unique_ptr<T> obj) {
+    T *raw = obj.get();
+    objects.emplace(raw->Handle(), std::move(obj));
+    return raw;
+}
+
+FakeJniEnv::FakeJniEnv() {
+    InstallTable();
+    functions = &table;
+}
+
+FakeJniEnv::~FakeJniEnv() = default;
+
+jstring FakeJniEnv::MakeString(const char *utf8) { return NewStringUTF(utf8); }
+
+std::string FakeJniEnv::ToUtf8(jstring str) const {
+    std::string out;
+    for (char16_t c : AsString(str)->chars) out.push_back(char(c));
+    return out;
+}
+
+std::vector<jbyte> FakeJniEnv::Bytes(jbyteArray array) const { return AsArray(array)->data; }
+
+void FakeJniEnv::DefineClass(const char *name, std::vector<Method> methods) {
+    auto clazz = std::make_unique<Class>();
+    clazz->name = name;
+    clazz->methods = std::move(methods);
+    Class *raw = Adopt(std::move(clazz));
+    globals.insert(raw);
+    classes[name] = raw;
+}
+
+const FakeJniEnv::Method *FakeJniEnv::FindMethod(const char *clazz, const char *name, const char *signature) const {
+    auto it = classes.find(clazz);
+    if (it == classes.end()) return nullptr;
+    for (const Method &m : it->second->methods) {
+        if (m.name == name && m.signature == signature) return &m;
+    }
+    return nullptr;
+}
+
+void FakeJniEnv::Reset() {
+    for (auto it = objects.begin(); it != objects.end();) {
+        if (globals.count(it->first)) ++it;
+        else it = objects.erase(it);
+    }
+    exception = false;
+}
+
+void FakeJniEnv::InstallTable() {
+    memset(&table, 0, sizeof(table));
+
+    table.FindClass = [](JNIEnv *env, const char *name) -> jclass {
+        FakeJniEnv *self = Self(env);
+        auto it = self->classes.find(name);
+        if (it == self->classes.end()) {
+            self->exception = true;
+            return nullptr;
+        }
+        return it->second;
+    };
+    table.ExceptionCheck = [](JNIEnv *env) -> jboolean { return Self(env)->exception; };
+    table.ExceptionClear = [](JNIEnv *env) { Self(env)->exception = false; };
+    table.NewGlobalRef = [](JNIEnv *env, jobject obj) -> jobject {
+        if (obj != nullptr) Self(env)->globals.insert(obj);
+        return obj;
+    };
+    table.DeleteGlobalRef = [](JNIEnv *env, jobject obj) {
+        FakeJniEnv *self = Self(env);
+        // DefineClass 的类与真实 VM 中的类一样常驻，不随引用释放
+        for (const auto &entry : self->classes) {
+            if (entry.second == obj) return;
+        }
+        if (self->globals.erase(obj)) self->objects.erase(obj);
+    };
+    table.DeleteLocalRef = [](JNIEnv *env, jobject obj) {
+        FakeJniEnv *self = Self(env);
+        if (!self->globals.count(obj)) self->objects.erase(obj);
+    };
+    // 对象指针即引用，局部引用与全局引用指向同一个对象
+    table.NewLocalRef = [](JNIEnv *, jobject obj) -> jobject { return obj; };
+    table.IsSameObject = [](JNIEnv *, jobject a, jobject b) -> jboolean { return a == b; };
+
+    auto getMethod = [](JNIEnv *env, jclass clazz, const char *name, const char *sig, bool isStatic) -> jmethodID {
+        for (Method &m : AsClass(clazz)->methods) {
+            if (m.is_static == isStatic && m.name == name && m.signature == sig) {
+                return reinterpret_cast<jmethodID>(&m);
+            }
+        }
+        Self(env)->exception = true;
+        return nullptr;
+    };
+    static decltype(getMethod) s_getMethod = getMethod;
+    table.GetMethodID = [](JNIEnv *env, jclass clazz, const char *name, const char *sig) {
+        return s_getMethod(env, clazz, name, sig, false);
+    };
+    table.GetStaticMethodID = [](JNIEnv *env, jclass clazz, const char *name, const char *sig) {
+        return s_getMethod(env, clazz, name, sig, true);
+    };
+
+    table.NewString = [](JNIEnv *env, const jchar *chars, jsize len) -> jstring {
+        auto str = std::make_unique<String>();
+        str->chars.assign(reinterpret_cast<const char16_t *>(chars), size_t(len));
+        return Self(env)->Adopt(std::move(str));
+    };
+    table.GetStringLength = [](JNIEnv *, jstring str) -> jsize { return jsize(AsString(str)->chars.size()); };
+    table.GetStringChars = [](JNIEnv *, jstring str, jboolean *isCopy) -> const jchar * {
+        if (isCopy) *isCopy = JNI_FALSE;
+        return reinterpret_cast<const jchar *>(AsString(str)->chars.data());
+    };
+    table.ReleaseStringChars = [](JNIEnv *, jstring, const jchar *) {};
+    table.NewStringUTF = [](JNIEnv *env, const char *bytes) -> jstring {
+        auto str = std::make_unique<String>();
+        for (const char *p = bytes; *p; p++) str->chars.push_back(char16_t(uint8_t(*p)));
+        return Self(env)->Adopt(std::move(str));
+    };
+    table.GetStringUTFLength = [](JNIEnv *, jstring str) -> jsize { return jsize(AsString(str)->chars.size()); };
+    // 与 ART 一样返回一份新分配的拷贝
+    table.GetStringUTFChars = [](JNIEnv *, jstring str, jboolean *isCopy) -> const char * {
+        if (isCopy) *isCopy = JNI_TRUE;
+        const std::u16string &chars = AsString(str)->chars;
+        char *utf = new char[chars.size() + 1];
+        for (size_t i = 0; i < chars.size(); i++) utf[i] = char(chars[i]);
+        utf[chars.size()] = '\0';
+        return utf;
+    };
+    table.ReleaseStringUTFChars = [](JNIEnv *, jstring, const char *utf) { delete[] utf; };
+    table.GetArrayLength = [](JNIEnv *, jarray array) -> jsize { return jsize(AsArray(array)->data.size()); };
+    table.NewByteArray = [](JNIEnv *env, jsize length) -> jbyteArray {
+        auto array = std::make_unique<ByteArray>();
+        array->data.resize(size_t(length));
+        return Self(env)->Adopt(std::move(array));
+    };
+    table.GetByteArrayRegion = [](JNIEnv *, jbyteArray array, jsize start, jsize len, jbyte *buf) {
+        memcpy(buf, AsArray(array)->data.data() + start, size_t(len));
+    };
+    table.SetByteArrayRegion = [](JNIEnv *, jbyteArray array, jsize start, jsize len, const jbyte *buf) {
+        memcpy(AsArray(array)->data.data() + start, buf, size_t(len));
+    };
+    table.RegisterNatives = [](JNIEnv *env, jclass clazz, const JNINativeMethod *methods, jint count) -> jint {
+        Class *cls = AsClass(clazz);
+        for (jint i = 0; i < count; i++) {
+            bool found = false;
+            for (Method &m : cls->methods) {
+                if (m.name == methods[i].name && m.signature == methods[i].signature) {
+                    m.fnPtr = methods[i].fnPtr;
+                    found = true;
+                }
+            }
+            if (!found) {
+                Self(env)->exception = true;
+                return JNI_ERR;
+            }
+        }
+        return JNI_OK;
+    };
+    table.GetStringRegion = [](JNIEnv *, jstring str, jsize start, jsize len, jchar *buf) {
+        memcpy(buf, AsString(str)->chars.data() + start, size_t(len) * sizeof(jchar));
+    };
+    table.GetStringUTFRegion = [](JNIEnv *, jstring str, jsize start, jsize len, char *buf) {
+        const std::u16string &chars = AsString(str)->chars;
+        for (jsize i = 0; i < len; i++) buf[i] = char(chars[size_t(start + i)]);
+        buf[len] = '\0';
+    };
+    table.GetStringCritical = [](JNIEnv *, jstring str, jboolean *isCopy) -> const jchar * {
+        if (isCopy) *isCopy = JNI_FALSE;
+        return reinterpret_cast<const jchar *>(AsString(str)->chars.data());
+    };
+    table.ReleaseStringCritical = [](JNIEnv *, jstring, const jchar *) {};
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <jni.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 宿主机上的假 JNIEnv：String / byte[] / Class 都是普通堆对象。
+// 新建对象一律视为局部引用，Reset() 统一释放；NewGlobalRef 过的对象保留到 DeleteGlobalRef。
+class FakeJniEnv : public JNIEnv {
+public:
+    struct Method {
+        std::string name;
+        std::string signature;
+        bool is_static;
+        void *fnPtr;
+    };
+
+    FakeJniEnv();
+    ~FakeJniEnv();
+
+    FakeJniEnv(const FakeJniEnv &) = delete;
+    FakeJniEnv &operator=(const FakeJniEnv &) = delete;
+
+    // 以 ASCII/UTF-8（仅 BMP）创建 Java 字符串
+    jstring MakeString(const char *utf8);
+    std::string ToUtf8(jstring str) const;
+    std::vector<jbyte> Bytes(jbyteArray array) const;
+
+    // 声明一个类及其方法，供 FindClass / GetMethodID / RegisterNatives 使用
+    void DefineClass(const char *name, std::vector<Method> methods);
+    const Method *FindMethod(const char *clazz, const char *name, const char *signature) const;
+
+    // 释放所有局部引用
+    void Reset();
+    size_t LiveObjects() const { return objects.size(); }
+    bool PendingException() const { return exception; }
+
+private:
+    struct Object;
+    struct String;
+    struct ByteArray;
+    struct Class;
+
+    JNINativeInterface table;
+    std::unordered_map<_jobject *, std::unique_ptr<Object>> objects;
+    std::unordered_set<_jobject *> globals;
+    std::unordered_map<std::string, Class *> classes;
+    bool exception = false;
+
+    template <typename T>
+    T *Adopt(std::unique_ptr<T> obj);
+
+    static FakeJniEnv *Self(JNIEnv *env) { return static_cast<FakeJniEnv *>(env); }
+    static String *AsString(jstring str);
+    static ByteArray *AsArray(jarray array);
+    static Class *AsClass(jclass clazz);
+    void InstallTable();
+};
@@ -0,0 +1,199 @@
+#include "bench.h"
+#include "zygisk_device_random.h"
+#include "identity_profile.h"
+#include "rand_batch.h"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 对比 RandUtil 的 std::string 版本与定长缓冲区版本的单次生成耗时
+static void BenchRandUtil() {
+    Bench::Run("string/Hex16", [] { Bench::DoNotOptimize(RandUtil::Hex(16)); });
+    Bench::Run("string/IMEI", [] { Bench::DoNotOptimize(RandUtil::IMEI()); });
+    Bench::Run("string/Mobile", [] { Bench::DoNotOptimize(RandUtil::Mobile()); });
+    Bench::Run("string/SimSerial", [] { Bench::DoNotOptimize(RandUtil::SimSerial()); });
+    Bench::Run("string/MAC", [] { Bench::DoNotOptimize(RandUtil::MAC()); });
+    Bench::Run("string/MediaDrmID", [] { Bench::DoNotOptimize(RandUtil::MediaDrmID()); });
+    Bench::Run("string/SimOperator", [] { Bench::DoNotOptimize(RandUtil::SimOperator()); });
+    Bench::Run("string/HardwareID", [] { Bench::DoNotOptimize(RandUtil::HardwareID()); });
+
+    Bench::Run("fixed/Hex16", [] {
+        RandUtil::IdBuf<RandUtil::kHexIdLen> buf;
+        RandUtil::Hex(buf);
+        Bench::DoNotOptimize(buf);
+    });
+    Bench::Run("fixed/IMEI", [] {
+        RandUtil::IdBuf<RandUtil::kImeiLen> buf;
+        RandUtil::IMEI(buf);
+        Bench::DoNotOptimize(buf);
+    });
+    Bench::Run("fixed/Mobile", [] {
+        RandUtil::IdBuf<RandUtil::kMobileLen> buf;
+        RandUtil::Mobile(buf);
+        Bench::DoNotOptimize(buf);
+    });
+    Bench::Run("fixed/SimSerial", [] {
+        RandUtil::IdBuf<RandUtil::kSimSerialLen> buf;
+        RandUtil::SimSerial(buf);
+        Bench::DoNotOptimize(buf);
+    });
+    Bench::Run("fixed/MAC", [] {
+        RandUtil::IdBuf<RandUtil::kMacLen> buf;
+        RandUtil::MAC(buf);
+        Bench::DoNotOptimize(buf);
+    });
+    Bench::Run("fixed/MediaDrmID", [] {
+        RandUtil::IdBuf<RandUtil::kMediaDrmIdLen> buf;
+        RandUtil::MediaDrmID(buf);
+        Bench::DoNotOptimize(buf);
+    });
+    Bench::Run("fixed/SimOperator", [] {
+        RandUtil::IdBuf<RandUtil::kSimOperatorLen> buf;
+        RandUtil::SimOperator(buf);
+        Bench::DoNotOptimize(buf);
+    });
+    Bench::Run("fixed/HardwareID", [] {
+        RandUtil::IdBuf<RandUtil::kHardwareIdMaxLen> buf;
+        Bench::DoNotOptimize(RandUtil::HardwareID(buf));
+        Bench::DoNotOptimize(buf);
+    });
+}
+
+// 种子派生身份：单个字段按需计算的开销
+static void BenchIdentityProfile() {
+    static const IdentityProfile profile = IdentityProfile::Random();
+    static uint32_t slot = 0;
+    Bench::Run("profile/IMEI", [] {
+        RandUtil::IdBuf<RandUtil::kImeiLen> buf;
+        profile.IMEI(buf, slot++);
+        Bench::DoNotOptimize(buf);
+    });
+    Bench::Run("profile/MediaDrmID", [] {
+        RandUtil::IdBuf<RandUtil::kMediaDrmIdLen> buf;
+        profile.MediaDrmID(buf, slot++);
+        Bench::DoNotOptimize(buf);
+    });
+}
+
+// 批量生成：每条记录的平均耗时（对照 fixed/* 的逐条生成）
+static void BenchBatch() {
+    constexpr size_t kCount = 10000;
+    static std::vector<char> arena(kCount * RandUtil::RecordStride(RandUtil::Format::MediaDrmId));
+    const struct { const char *name; RandUtil::Format format; } cases[] = {
+            {"batch/IMEI", RandUtil::Format::Imei},
+            {"batch/SimSerial", RandUtil::Format::SimSerial},
+            {"batch/AndroidId", RandUtil::Format::AndroidId},
+            {"batch/MediaDrmID", RandUtil::Format::MediaDrmId},
+            {"batch/MAC", RandUtil::Format::Mac},
+    };
+    for (const auto &c : cases) {
+        Bench::Run(c.name, [&] {
+            Bench::DoNotOptimize(RandUtil::GenerateBatch(c.format, kCount, arena));
+        }, kCount);
+    }
+}
+
+// 多线程吞吐：每线程独立 xoshiro256** 对比加锁共享 mt19937_64（原来的单一全局引擎
+// 不加锁是数据竞争，这里用互斥锁作为正确的对照组）
+template <typename F>
+static double ThreadsMops(int threads, uint64_t opsPerThread, F &&body) {
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&] {
+            for (uint64_t i = 0; i < opsPerThread; i++) body();
+        });
+    }
+    for (auto &th : pool) th.join();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    return double(opsPerThread) * threads / us;
+}
+
+static void BenchEngineScaling() {
+    constexpr uint64_t kOps = 1 << 22;
+    static std::mutex lock;
+    static std::mt19937_64 shared(std::random_device{}());
+    for (int threads : {1, 2, 4, 8, 16}) {
+        std::string local = "engine/xoshiro-tls/threads=" + std::to_string(threads);
+        std::string locked = "engine/mt19937-locked/threads=" + std::to_string(threads);
+        // 以聚合吞吐折算 ns/op，没有单次延迟分位数
+        if (Bench::Selected(local.c_str())) {
+            double mops = ThreadsMops(threads, kOps, [] {
+                Bench::DoNotOptimize(RandUtil::Engine()());
+            });
+            Bench::Record({local, 1000.0 / mops, 0, 0, 0});
+        }
+        if (Bench::Selected(locked.c_str())) {
+            double mops = ThreadsMops(threads, kOps, [] {
+                std::lock_guard<std::mutex> guard(lock);
+                Bench::DoNotOptimize(shared());
+            });
+            Bench::Record({locked, 1000.0 / mops, 0, 0, 0});
+        }
+    }
+}
+
+void BenchLog();
+void BenchTrace();
+void BenchStats();
+void BenchHooks();
+void BenchJni();
+void BenchSnapshot();
+void BenchXdl();
+
+static void Usage(const char *argv0) {
+    std::fprintf(stderr, "usage: %s [--filter SUBSTR] [--json OUT] [--compare BASELINE] [--threshold PCT]\n", argv0);
+}
+
+int main(int argc, char **argv) {
+    Bench::Options &opts = Bench::Opts();
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr) {
+            Usage(argv[0]);
+            return 2;
+        }
+        if (strcmp(arg, "--filter") == 0) opts.filter = value;
+        else if (strcmp(arg, "--json") == 0) opts.json = value;
+        else if (strcmp(arg, "--compare") == 0) opts.compare = value;
+        else if (strcmp(arg, "--threshold") == 0) opts.threshold = strtod(value, nullptr);
+        else {
+            Usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    BenchRandUtil();
+    BenchIdentityProfile();
+    BenchBatch();
+    BenchEngineScaling();
+    BenchLog();
+    BenchTrace();
+    BenchStats();
+    BenchHooks();
+    BenchJni();
+    BenchSnapshot();
+    BenchXdl();
+
+    if (opts.json && !Bench::WriteJson(opts.json)) {
+        std::fprintf(stderr, "cannot write %s\n", opts.json);
+        return 2;
+    }
+    if (opts.compare) {
+        int regressions = Bench::Compare(opts.compare, opts.threshold);
+        if (regressions < 0) {
+            std::fprintf(stderr, "cannot read %s\n", opts.compare);
+            return 2;
+        }
+        if (regressions > 0) {
+            std::printf("%d regression(s) over %.1f%%\n", regressions, opts.threshold);
+            return 1;
+        }
+    }
+    return 0;
+}
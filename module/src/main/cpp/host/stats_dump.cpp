@@ -0,0 +1,121 @@
+#include "hook_stats.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 读取 traces/<包名>.stats 并输出快照（应用运行中也可读取）：
+//   randomid_stats app.stats [--prom | --json]
+// 默认输出 Prometheus 文本格式。
+
+namespace {
+    using namespace HookStats;
+
+    struct Totals {
+        uint64_t calls = 0;
+        uint64_t sum_ticks = 0;
+        uint64_t buckets[kBuckets] = {};
+    };
+
+    // 分位数取所在桶的上界，与 Prometheus 的 le 语义一致
+    double Quantile(const Totals &t, double q, double nsPerTick) {
+        if (t.calls == 0) return 0;
+        uint64_t rank = uint64_t(q * double(t.calls - 1)) + 1, seen = 0;
+        for (uint32_t b = 0; b < kBuckets; b++) {
+            seen += t.buckets[b];
+            if (seen >= rank) return double(b + 1 < kBuckets ? BucketLow(b + 1) : BucketLow(b)) * nsPerTick;
+        }
+        return 0;
+    }
+
+    void PrintProm(const Region &r, const Totals *totals, double nsPerTick) {
+        printf("# HELP randomid_hook_calls_total Hook invocations.\n# TYPE randomid_hook_calls_total counter\n");
+        for (uint32_t h = 0; h < r.header.hooks; h++) {
+            printf("randomid_hook_calls_total{hook=\"%s\",pid=\"%d\"} %" PRIu64 "\n", kHookNames[h], r.header.pid,
+                   totals[h].calls);
+        }
+        printf("# HELP randomid_hook_latency_seconds Hook latency.\n# TYPE randomid_hook_latency_seconds histogram\n");
+        for (uint32_t h = 0; h < r.header.hooks; h++) {
+            const Totals &t = totals[h];
+            if (t.calls == 0) continue;
+            uint64_t cumulative = 0;
+            for (uint32_t b = 0; b + 1 < kBuckets; b++) {
+                if (t.buckets[b] == 0) continue;
+                cumulative += t.buckets[b];
+                printf("randomid_hook_latency_seconds_bucket{hook=\"%s\",le=\"%.9g\"} %" PRIu64 "\n", kHookNames[h],
+                       double(BucketLow(b + 1)) * nsPerTick * 1e-9, cumulative);
+            }
+            printf("randomid_hook_latency_seconds_bucket{hook=\"%s\",le=\"+Inf\"} %" PRIu64 "\n", kHookNames[h], t.calls);
+            printf("randomid_hook_latency_seconds_sum{hook=\"%s\"} %.9g\n", kHookNames[h],
+                   double(t.sum_ticks) * nsPerTick * 1e-9);
+            printf("randomid_hook_latency_seconds_count{hook=\"%s\"} %" PRIu64 "\n", kHookNames[h], t.calls);
+        }
+    }
+
+    void PrintJson(const Region &r, const Totals *totals, double nsPerTick) {
+        printf("{\n  \"pid\": %d,\n  \"ticks_per_sec\": %" PRIu64 ",\n  \"hooks\": [\n", r.header.pid,
+               r.header.ticks_per_sec);
+        for (uint32_t h = 0; h < r.header.hooks; h++) {
+            const Totals &t = totals[h];
+            double mean = t.calls ? double(t.sum_ticks) * nsPerTick / double(t.calls) : 0;
+            printf("    {\"hook\": \"%s\", \"calls\": %" PRIu64 ", \"mean_ns\": %.1f, \"p50_ns\": %.1f, "
+                   "\"p90_ns\": %.1f, \"p99_ns\": %.1f}%s\n",
+                   kHookNames[h], t.calls, mean, Quantile(t, 0.5, nsPerTick), Quantile(t, 0.9, nsPerTick),
+                   Quantile(t, 0.99, nsPerTick), h + 1 < r.header.hooks ? "," : "");
+        }
+        printf("  ]\n}\n");
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s FILE.stats [--prom | --json]\n", argv[0]);
+        return 2;
+    }
+    bool json = argc > 2 && strcmp(argv[2], "--json") == 0;
+
+    int fd = open(argv[1], O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) {
+        fprintf(stderr, "%s: cannot open stats file\n", argv[1]);
+        return 1;
+    }
+    size_t mapSize = size_t(st.st_size);
+    void *map = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    const auto &region = *static_cast<const Region *>(map);
+    const Header &header = region.header;
+    // HookId 只追加不改号：较早的模块写入的文件 Hook 更少，按文件自己的 hooks 跨步读取
+    if (header.magic != kMagic || header.version != kVersion || header.shards != kShards ||
+        header.hooks == 0 || header.hooks > uint32_t(HookId::kCount) || header.buckets != kBuckets ||
+        mapSize < sizeof(Header) + size_t(header.shards) * header.hooks * sizeof(HookCell)) {
+        fprintf(stderr, "%s: not a v%u stats file\n", argv[1], kVersion);
+        return 1;
+    }
+    const auto *cells = reinterpret_cast<const HookCell *>(&header + 1);
+
+    // 各分片逐个 relaxed 读取；应用同时在写，快照只保证每个计数器自身不撕裂
+    Totals totals[size_t(HookId::kCount)];
+    for (uint32_t s = 0; s < header.shards; s++) {
+        for (uint32_t h = 0; h < header.hooks; h++) {
+            const HookCell &cell = cells[size_t(s) * header.hooks + h];
+            totals[h].calls += cell.calls.load(std::memory_order_relaxed);
+            totals[h].sum_ticks += cell.sum_ticks.load(std::memory_order_relaxed);
+            for (uint32_t b = 0; b < kBuckets; b++) {
+                totals[h].buckets[b] += cell.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    double nsPerTick = 1e9 / double(header.ticks_per_sec);
+    if (json) PrintJson(region, totals, nsPerTick);
+    else PrintProm(region, totals, nsPerTick);
+    munmap(map, mapSize);
+    return 0;
+}
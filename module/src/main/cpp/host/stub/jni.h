@@ -0,0 +1,131 @@
+#pragma once
+// 宿主机替身：JNI 类型与 JNIEnv 的精简子集，只包含模块用到的函数。
+// 函数表布局与真实 jni.h 不同，仅用于在宿主机上配合 FakeJniEnv 编译、测试模块代码。
+#include <cstdarg>
+#include <cstdint>
+
+typedef uint8_t jboolean;
+typedef int8_t jbyte;
+typedef uint16_t jchar;
+typedef int16_t jshort;
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef float jfloat;
+typedef double jdouble;
+typedef jint jsize;
+
+class _jobject {};
+class _jclass : public _jobject {};
+class _jstring : public _jobject {};
+class _jthrowable : public _jobject {};
+class _jarray : public _jobject {};
+class _jbyteArray : public _jarray {};
+class _jintArray : public _jarray {};
+class _jobjectArray : public _jarray {};
+
+typedef _jobject *jobject;
+typedef _jclass *jclass;
+typedef _jstring *jstring;
+typedef _jthrowable *jthrowable;
+typedef _jarray *jarray;
+typedef _jbyteArray *jbyteArray;
+typedef _jintArray *jintArray;
+typedef _jobjectArray *jobjectArray;
+
+struct _jmethodID;
+typedef struct _jmethodID *jmethodID;
+
+#define JNI_FALSE 0
+#define JNI_TRUE 1
+#define JNI_OK 0
+#define JNI_ERR (-1)
+#define JNI_ABORT 2
+
+typedef struct {
+    const char *name;
+    const char *signature;
+    void *fnPtr;
+} JNINativeMethod;
+
+struct _JNIEnv;
+typedef _JNIEnv JNIEnv;
+
+struct JNINativeInterface {
+    jclass (*FindClass)(JNIEnv *, const char *);
+    jboolean (*ExceptionCheck)(JNIEnv *);
+    void (*ExceptionClear)(JNIEnv *);
+    jobject (*NewGlobalRef)(JNIEnv *, jobject);
+    void (*DeleteGlobalRef)(JNIEnv *, jobject);
+    void (*DeleteLocalRef)(JNIEnv *, jobject);
+    jobject (*NewLocalRef)(JNIEnv *, jobject);
+    jboolean (*IsSameObject)(JNIEnv *, jobject, jobject);
+    jmethodID (*GetMethodID)(JNIEnv *, jclass, const char *, const char *);
+    jmethodID (*GetStaticMethodID)(JNIEnv *, jclass, const char *, const char *);
+    jstring (*NewString)(JNIEnv *, const jchar *, jsize);
+    jsize (*GetStringLength)(JNIEnv *, jstring);
+    const jchar *(*GetStringChars)(JNIEnv *, jstring, jboolean *);
+    void (*ReleaseStringChars)(JNIEnv *, jstring, const jchar *);
+    jstring (*NewStringUTF)(JNIEnv *, const char *);
+    jsize (*GetStringUTFLength)(JNIEnv *, jstring);
+    const char *(*GetStringUTFChars)(JNIEnv *, jstring, jboolean *);
+    void (*ReleaseStringUTFChars)(JNIEnv *, jstring, const char *);
+    jsize (*GetArrayLength)(JNIEnv *, jarray);
+    jbyteArray (*NewByteArray)(JNIEnv *, jsize);
+    void (*GetByteArrayRegion)(JNIEnv *, jbyteArray, jsize, jsize, jbyte *);
+    void (*SetByteArrayRegion)(JNIEnv *, jbyteArray, jsize, jsize, const jbyte *);
+    jint (*RegisterNatives)(JNIEnv *, jclass, const JNINativeMethod *, jint);
+    void (*GetStringRegion)(JNIEnv *, jstring, jsize, jsize, jchar *);
+    void (*GetStringUTFRegion)(JNIEnv *, jstring, jsize, jsize, char *);
+    const jchar *(*GetStringCritical)(JNIEnv *, jstring, jboolean *);
+    void (*ReleaseStringCritical)(JNIEnv *, jstring, const jchar *);
+};
+
+struct _JNIEnv {
+    const struct JNINativeInterface *functions;
+
+    jclass FindClass(const char *name) { return functions->FindClass(this, name); }
+    jboolean ExceptionCheck() { return functions->ExceptionCheck(this); }
+    void ExceptionClear() { functions->ExceptionClear(this); }
+    jobject NewGlobalRef(jobject obj) { return functions->NewGlobalRef(this, obj); }
+    void DeleteGlobalRef(jobject obj) { functions->DeleteGlobalRef(this, obj); }
+    void DeleteLocalRef(jobject obj) { functions->DeleteLocalRef(this, obj); }
+    jobject NewLocalRef(jobject obj) { return functions->NewLocalRef(this, obj); }
+    jboolean IsSameObject(jobject a, jobject b) { return functions->IsSameObject(this, a, b); }
+    jmethodID GetMethodID(jclass clazz, const char *name, const char *sig) {
+        return functions->GetMethodID(this, clazz, name, sig);
+    }
+    jmethodID GetStaticMethodID(jclass clazz, const char *name, const char *sig) {
+        return functions->GetStaticMethodID(this, clazz, name, sig);
+    }
+    jstring NewString(const jchar *chars, jsize len) { return functions->NewString(this, chars, len); }
+    jsize GetStringLength(jstring str) { return functions->GetStringLength(this, str); }
+    const jchar *GetStringChars(jstring str, jboolean *isCopy) { return functions->GetStringChars(this, str, isCopy); }
+    void ReleaseStringChars(jstring str, const jchar *chars) { functions->ReleaseStringChars(this, str, chars); }
+    jstring NewStringUTF(const char *bytes) { return functions->NewStringUTF(this, bytes); }
+    jsize GetStringUTFLength(jstring str) { return functions->GetStringUTFLength(this, str); }
+    const char *GetStringUTFChars(jstring str, jboolean *isCopy) {
+        return functions->GetStringUTFChars(this, str, isCopy);
+    }
+    void ReleaseStringUTFChars(jstring str, const char *utf) { functions->ReleaseStringUTFChars(this, str, utf); }
+    jsize GetArrayLength(jarray array) { return functions->GetArrayLength(this, array); }
+    jbyteArray NewByteArray(jsize length) { return functions->NewByteArray(this, length); }
+    void GetByteArrayRegion(jbyteArray array, jsize start, jsize len, jbyte *buf) {
+        functions->GetByteArrayRegion(this, array, start, len, buf);
+    }
+    void SetByteArrayRegion(jbyteArray array, jsize start, jsize len, const jbyte *buf) {
+        functions->SetByteArrayRegion(this, array, start, len, buf);
+    }
+    jint RegisterNatives(jclass clazz, const JNINativeMethod *methods, jint nMethods) {
+        return functions->RegisterNatives(this, clazz, methods, nMethods);
+    }
+    void GetStringRegion(jstring str, jsize start, jsize len, jchar *buf) {
+        functions->GetStringRegion(this, str, start, len, buf);
+    }
+    void GetStringUTFRegion(jstring str, jsize start, jsize len, char *buf) {
+        functions->GetStringUTFRegion(this, str, start, len, buf);
+    }
+    const jchar *GetStringCritical(jstring str, jboolean *isCopy) {
+        return functions->GetStringCritical(this, str, isCopy);
+    }
+    void ReleaseStringCritical(jstring str, const jchar *chars) { functions->ReleaseStringCritical(this, str, chars); }
+};
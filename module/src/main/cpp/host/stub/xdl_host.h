@@ -0,0 +1,21 @@
+#pragma once
+// 宿主机编译 xDL 时强制包含（-include）：补上 bionic 头文件隐式提供、glibc 没有的声明。
+#include <android/api-level.h>
+#include <elf.h>
+#include <string.h>
+
+#ifndef ELF_ST_TYPE
+#define ELF_ST_TYPE(x) (((unsigned int)(x)) & 0xf)
+#endif
+
+#if !defined(__BIONIC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+static inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size > 0) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#endif
@@ -0,0 +1,95 @@
+#include "hook_trace.h"
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 把 traces/<包名>.trace 还原为文本或 CSV：
+//   randomid_trace_decode app.trace [--csv]
+// 记录按序号从旧到新输出；循环覆盖过的部分只保留最近 capacity 条。
+
+static std::string Render(const char *text, const HookTrace::Record &rec) {
+    std::string out;
+    char buf[16];
+    for (const char *p = text; *p; p++) {
+        if (strncmp(p, "{ret}", 5) == 0) {
+            snprintf(buf, sizeof(buf), "%08x", rec.ret_hash);
+            out += buf;
+            p += 4;
+        } else if (strncmp(p, "{arg}", 5) == 0) {
+            snprintf(buf, sizeof(buf), "%u", rec.arg);
+            out += buf;
+            p += 4;
+        } else {
+            out += *p;
+        }
+    }
+    return out;
+}
+
+static std::string CsvQuote(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s FILE.trace [--csv]\n", argv[0]);
+        return 2;
+    }
+    bool csv = argc > 2 && strcmp(argv[2], "--csv") == 0;
+
+    FILE *fp = fopen(argv[1], "rb");
+    if (fp == nullptr) {
+        perror(argv[1]);
+        return 1;
+    }
+    HookTrace::Header header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != HookTrace::kMagic ||
+        header.version != HookTrace::kVersion || header.record_size != sizeof(HookTrace::Record)) {
+        fprintf(stderr, "%s: not a v%u trace file\n", argv[1], HookTrace::kVersion);
+        fclose(fp);
+        return 1;
+    }
+    std::vector<HookTrace::Record> records(header.capacity);
+    size_t loaded = fread(records.data(), sizeof(HookTrace::Record), records.size(), fp);
+    fclose(fp);
+
+    uint64_t next = header.next.load(std::memory_order_relaxed);
+    uint64_t first = next > header.capacity ? next - header.capacity : 0;
+
+    if (csv) {
+        printf("seq,wall_ns,ticks,tid,caller_pc,hook,event,ret_hash,arg,text\n");
+    } else {
+        printf("# pid %d, %" PRIu64 " events, %" PRIu64 " kept\n", header.pid, next, next - first);
+    }
+    for (uint64_t seq = first; seq < next; seq++) {
+        size_t index = seq % header.capacity;
+        if (index >= loaded) break;
+        const HookTrace::Record &rec = records[index];
+        // 序号已分配但进程在写完前退出
+        if (rec.ticks == 0) continue;
+        // 比解码器更新的模块写入的 Hook / 事件没有文本，跳过
+        const HookTrace::EventInfo *found = HookTrace::FindEvent(rec.hook, rec.event);
+        if (found == nullptr) continue;
+        const HookTrace::EventInfo &ev = *found;
+        const char *hook = kHookNames[rec.hook];
+        double offset = double(int64_t(rec.ticks - header.base_ticks)) * 1e9 / double(header.ticks_per_sec);
+        int64_t wall = header.realtime_ns + int64_t(offset);
+        std::string text = Render(ev.text, rec);
+        if (csv) {
+            printf("%" PRIu64 ",%" PRId64 ",%" PRIu64 ",%u,0x%" PRIx64 ",%s,%s,%08x,%u,%s\n",
+                   seq, wall, rec.ticks, rec.tid, rec.caller_pc, hook, ev.name, rec.ret_hash, rec.arg,
+                   CsvQuote(text).c_str());
+        } else {
+            printf("%" PRId64 ".%09" PRId64 " %6u %#14" PRIx64 " %-20s %s\n",
+                   wall / 1000000000, wall % 1000000000, rec.tid, rec.caller_pc, hook, text.c_str());
+        }
+    }
+    return 0;
+}
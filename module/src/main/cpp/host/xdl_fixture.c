@@ -0,0 +1,19 @@
+// xdl_addr 的重叠区间用例：同一起点上有一个 32 字节的外层符号和两个 8 字节的别名，
+// 外层内部偏移 16 处还有一个 4 字节的嵌套符号。只用 .skip 填充，与宿主机架构无关
+__asm__(".text\n"
+        ".p2align 4\n"
+        ".globl xdl_fixture_outer, xdl_fixture_inner, xdl_fixture_inner_alias, xdl_fixture_nested\n"
+        ".type xdl_fixture_outer, %function\n"
+        ".type xdl_fixture_inner, %function\n"
+        ".type xdl_fixture_inner_alias, %function\n"
+        ".type xdl_fixture_nested, %function\n"
+        "xdl_fixture_outer:\n"
+        "xdl_fixture_inner:\n"
+        "xdl_fixture_inner_alias:\n"
+        ".skip 16\n"
+        "xdl_fixture_nested:\n"
+        ".skip 16\n"
+        ".size xdl_fixture_outer, 32\n"
+        ".size xdl_fixture_inner, 8\n"
+        ".size xdl_fixture_inner_alias, 8\n"
+        ".size xdl_fixture_nested, 4\n");
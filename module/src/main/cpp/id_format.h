@@ -0,0 +1,313 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// 标识格式的编译期描述：
+//   Format<Digits<14>, Luhn>                  IMEI
+//   Format<Hex<2>, Sep<':'>, Hex<2>, ...>     MAC
+//   Format<OneOf<kPrefixes>, Digits<8>>       手机号
+// 每个 Format 在编译期算出各段偏移和总长度，Generate() 展开为直线代码，
+// 运行时不解释任何格式描述；输出写入定长 std::span，并以 '\0' 结尾。
+namespace IdFormat {
+    namespace detail {
+        inline constexpr char kHexLower[] = "0123456789abcdef";
+        inline constexpr char kHexUpper[] = "0123456789ABCDEF";
+        inline constexpr char kAlnumUpper[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+        template <typename Rng>
+        constexpr void CheckEngine() {
+            static_assert(Rng::min() == 0 && Rng::max() == UINT64_MAX,
+                          "IdFormat 要求 64 位满幅随机源");
+        }
+
+        constexpr uint32_t Pow10(size_t n) {
+            uint32_t v = 1;
+            for (size_t i = 0; i < n; i++) v *= 10;
+            return v;
+        }
+
+        constexpr bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+        // [0, n) 无偏整数（Lemire 乘法取高位 + 拒绝）
+        template <typename Rng>
+        inline uint32_t Bounded(uint32_t n, Rng &rng) {
+            uint64_t m = uint64_t(uint32_t(rng())) * n;
+            auto low = uint32_t(m);
+            if (low < n) {
+                uint32_t threshold = uint32_t(-n) % n;
+                while (low < threshold) {
+                    m = uint64_t(uint32_t(rng())) * n;
+                    low = uint32_t(m);
+                }
+            }
+            return uint32_t(m >> 32);
+        }
+
+        // 每个 64 位随机数拒绝采样到 [0, 10^18)，一次产出 18 位无偏十进制数字
+        template <typename Rng>
+        inline void FillDigits(char *out, size_t n, Rng &rng) {
+            constexpr uint64_t kBlock = 1000000000000000000ULL;
+            constexpr uint64_t kLimit = kBlock * 18;
+            while (n > 0) {
+                uint64_t x;
+                do { x = rng(); } while (x >= kLimit);
+                x %= kBlock;
+                // 拆成两个 9 位的 32 位数，两条除法链互相独立
+                auto lo = uint32_t(x % 1000000000);
+                auto hi = uint32_t(x / 1000000000);
+                size_t take = n < 18 ? n : 18;
+                size_t split = take < 9 ? take : 9;
+                for (size_t i = 0; i < split; i++) {
+                    out[i] = char('0' + lo % 10);
+                    lo /= 10;
+                }
+                for (size_t i = split; i < take; i++) {
+                    out[i] = char('0' + hi % 10);
+                    hi /= 10;
+                }
+                out += take;
+                n -= take;
+            }
+        }
+
+        // 每个 64 位随机数产出 16 位十六进制数字
+        template <typename Rng>
+        inline void FillHex(char *out, size_t n, const char *digits, Rng &rng) {
+            while (n > 0) {
+                uint64_t x = rng();
+                size_t take = n < 16 ? n : 16;
+                for (size_t i = 0; i < take; i++) {
+                    out[i] = digits[x & 0xf];
+                    x >>= 4;
+                }
+                out += take;
+                n -= take;
+            }
+        }
+
+        // Luhn 校验位：从右往左数，紧邻校验位的数字开始每隔一位加倍
+        inline char LuhnDigit(const char *digits, size_t n) {
+            int sum = 0;
+            for (size_t i = 0; i < n; i++) {
+                int num = digits[i] - '0';
+                if ((n - 1 - i) % 2 == 0) num = num * 2 > 9 ? num * 2 - 9 : num * 2;
+                sum += num;
+            }
+            return char('0' + (10 - sum % 10) % 10);
+        }
+
+        // 比特池：多个短字段（如 MAC 的 6 个字节）共用同一次 64 位抽取
+        template <typename Rng>
+        struct BitPool {
+            Rng &rng;
+            uint64_t bits = 0;
+            unsigned avail = 0;
+
+            // 取 n (1..64) 个均匀随机比特
+            uint64_t Take(unsigned n) {
+                if (avail < n) {
+                    bits = rng();
+                    avail = 64;
+                }
+                uint64_t v = n == 64 ? bits : bits & ((uint64_t(1) << n) - 1);
+                bits = n == 64 ? 0 : bits >> n;
+                avail -= n;
+                return v;
+            }
+        };
+    }
+
+    // 字符串字面量作为模板参数
+    template <size_t N>
+    struct FixedString {
+        char str[N];
+
+        constexpr FixedString(const char (&s)[N]) {
+            for (size_t i = 0; i < N; i++) str[i] = s[i];
+        }
+    };
+
+    // ---- 格式片段 ----
+    // 每个片段提供：kLen（输出字符数）、kDecimal（输出是否全为数字，Luhn 需要）、
+    // Emit<Off>(out, pool)（写入 out[Off, Off + kLen)）。
+
+    // N 位无偏十进制数字
+    template <size_t N>
+    struct Digits {
+        static_assert(N > 0);
+        static constexpr size_t kLen = N;
+        static constexpr bool kDecimal = true;
+
+        template <size_t Off, typename Pool>
+        static void Emit(char *out, Pool &pool) {
+            if constexpr (N <= 9) {
+                uint32_t v = detail::Bounded(detail::Pow10(N), pool.rng);
+                for (size_t i = 0; i < N; i++) {
+                    out[Off + N - 1 - i] = char('0' + v % 10);
+                    v /= 10;
+                }
+            } else {
+                detail::FillDigits(out + Off, N, pool.rng);
+            }
+        }
+    };
+
+    // N 位十六进制（小写 / 大写）
+    template <size_t N, bool Upper = false>
+    struct Hex {
+        static_assert(N > 0);
+        static constexpr size_t kLen = N;
+        static constexpr bool kDecimal = false;
+
+        template <size_t Off, typename Pool>
+        static void Emit(char *out, Pool &pool) {
+            const char *digits = Upper ? detail::kHexUpper : detail::kHexLower;
+            if constexpr (N <= 16) {
+                uint64_t v = pool.Take(unsigned(N * 4));
+                for (size_t i = 0; i < N; i++) {
+                    out[Off + i] = digits[v & 0xf];
+                    v >>= 4;
+                }
+            } else {
+                detail::FillHex(out + Off, N, digits, pool.rng);
+            }
+        }
+    };
+
+    template <size_t N>
+    using HexUpper = Hex<N, true>;
+
+    // N 位大写字母数字（序列号风格）
+    template <size_t N>
+    struct Alnum {
+        static_assert(N > 0);
+        static constexpr size_t kLen = N;
+        static constexpr bool kDecimal = false;
+
+        template <size_t Off, typename Pool>
+        static void Emit(char *out, Pool &pool) {
+            for (size_t i = 0; i < N; i++) out[Off + i] = detail::kAlnumUpper[detail::Bounded(36, pool.rng)];
+        }
+    };
+
+    // 固定字符串
+    template <FixedString S>
+    struct Lit {
+        static constexpr size_t kLen = sizeof(S.str) - 1;
+        static constexpr bool kDecimal = [] {
+            for (size_t i = 0; i < kLen; i++) {
+                if (!detail::IsDigit(S.str[i])) return false;
+            }
+            return true;
+        }();
+
+        template <size_t Off, typename Pool>
+        static void Emit(char *out, Pool &) {
+            for (size_t i = 0; i < kLen; i++) out[Off + i] = S.str[i];
+        }
+    };
+
+    // 单个分隔符
+    template <char C>
+    struct Sep {
+        static constexpr size_t kLen = 1;
+        static constexpr bool kDecimal = detail::IsDigit(C);
+
+        template <size_t Off, typename Pool>
+        static void Emit(char *out, Pool &) { out[Off] = C; }
+    };
+
+    // 从定宽字符串表中等概率选一项，表类型为 const char[K][W]（W 含结尾 '\0'）
+    template <const auto &Table>
+    struct OneOf {
+        using Row = std::remove_cvref_t<decltype(Table[0])>;
+        static constexpr size_t kLen = std::extent_v<Row> - 1;
+        static constexpr size_t kCount = std::extent_v<std::remove_cvref_t<decltype(Table)>>;
+        static constexpr bool kDecimal = [] {
+            for (size_t r = 0; r < kCount; r++) {
+                for (size_t i = 0; i < kLen; i++) {
+                    if (!detail::IsDigit(Table[r][i])) return false;
+                }
+            }
+            return true;
+        }();
+        static_assert(kCount > 0 && kLen > 0);
+
+        template <size_t Off, typename Pool>
+        static void Emit(char *out, Pool &pool) {
+            const char *row = Table[detail::Bounded(uint32_t(kCount), pool.rng)];
+            for (size_t i = 0; i < kLen; i++) out[Off + i] = row[i];
+        }
+    };
+
+    // Luhn 校验位：对之前所有输出计算，之前的片段必须全为数字（编译期检查）
+    struct Luhn {
+        static constexpr size_t kLen = 1;
+        static constexpr bool kDecimal = true;
+        static constexpr bool kChecksum = true;
+
+        template <size_t Off, typename Pool>
+        static void Emit(char *out, Pool &) {
+            static_assert(Off > 0, "Luhn 前面至少需要一位数字");
+            out[Off] = detail::LuhnDigit(out, Off);
+        }
+    };
+
+    template <typename Part>
+    constexpr bool IsChecksum() {
+        if constexpr (requires { Part::kChecksum; }) return Part::kChecksum;
+        else return false;
+    }
+
+    template <typename... Parts>
+    struct Format {
+        static constexpr size_t kLen = (Parts::kLen + ... + 0);
+        static_assert(kLen > 0, "空格式");
+
+        using Buffer = std::array<char, kLen + 1>;
+
+        template <typename Rng>
+        static void Generate(std::span<char, kLen + 1> out, Rng &rng) {
+            detail::CheckEngine<Rng>();
+            detail::BitPool<Rng> pool{rng};
+            Emit(out.data(), pool, std::index_sequence_for<Parts...>{});
+            out[kLen] = '\0';
+        }
+
+    private:
+        static constexpr size_t kParts = sizeof...(Parts);
+        static constexpr std::array<size_t, kParts> kLens = {Parts::kLen...};
+        static constexpr std::array<bool, kParts> kDecimals = {Parts::kDecimal...};
+        static constexpr std::array<bool, kParts> kChecksums = {IsChecksum<Parts>()...};
+
+        static constexpr std::array<size_t, kParts> kOffsets = [] {
+            std::array<size_t, kParts> offsets{};
+            size_t off = 0;
+            for (size_t i = 0; i < kParts; i++) {
+                offsets[i] = off;
+                off += kLens[i];
+            }
+            return offsets;
+        }();
+
+        static constexpr bool ChecksumInputsAreDecimal() {
+            for (size_t i = 0; i < kParts; i++) {
+                if (!kChecksums[i]) continue;
+                for (size_t j = 0; j < i; j++) {
+                    if (!kDecimals[j]) return false;
+                }
+            }
+            return true;
+        }
+        static_assert(ChecksumInputsAreDecimal(), "校验位之前只能是数字片段");
+
+        template <typename Pool, size_t... I>
+        static void Emit(char *out, Pool &pool, std::index_sequence<I...>) {
+            (Parts::template Emit<kOffsets[I]>(out, pool), ...);
+        }
+    };
+}
@@ -0,0 +1,143 @@
+#include "identity_pool.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "log.h"
+
+namespace {
+    constexpr uint32_t kReplyMagic = 0x4c4f4f50;  // "POOL"
+    constexpr uint32_t kPoolCapacity = 1024;
+
+    // companion 发回的应答：ok 为 0 时 record 无意义
+    struct Reply {
+        uint32_t magic;
+        uint32_t size;
+        uint32_t ok;
+        IdentityRecord record;
+    };
+
+    // ---------------------------------------------------------------- companion 端
+
+    // 记录只存在于 companion 的私有内存里，[head, tail) 为待领取的序号
+    struct Pool {
+        std::unique_ptr<IdentityRecord[]> slots;
+        uint64_t head = 0;
+        uint64_t tail = 0;
+        std::mutex lock;
+        std::condition_variable wakeup;
+    };
+
+    // companion 存活期间一直使用，补充线程是 detach 的，池不能随静态析构释放
+    Pool *s_pool = nullptr;
+    std::once_flag s_pool_once;
+
+    // 补齐所有已被领取的槽位。生成在锁外进行，领取只会被一次拷贝阻塞
+    void Refill() {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> guard(s_pool->lock);
+                if (s_pool->tail - s_pool->head >= kPoolCapacity) return;
+            }
+            IdentityRecord rec;
+            FillIdentityRecord(rec, IdentityProfile::Random());
+            std::lock_guard<std::mutex> guard(s_pool->lock);
+            memcpy(&s_pool->slots[s_pool->tail % kPoolCapacity], &rec, sizeof(rec));
+            s_pool->tail++;
+        }
+    }
+
+    void RefillLoop() {
+        for (;;) {
+            Refill();
+            std::unique_lock<std::mutex> guard(s_pool->lock);
+            s_pool->wakeup.wait_for(guard, std::chrono::seconds(1));
+        }
+    }
+
+    void CreatePool() {
+        auto *pool = new (std::nothrow) Pool;
+        if (pool != nullptr) pool->slots.reset(new (std::nothrow) IdentityRecord[kPoolCapacity]);
+        if (pool == nullptr || !pool->slots) {
+            delete pool;
+            LOGE("Cannot allocate identity pool, pool disabled");
+            return;
+        }
+        s_pool = pool;
+        Refill();
+        std::thread(RefillLoop).detach();
+        LOGI("Identity pool ready: %u records", kPoolCapacity);
+    }
+
+    // 取出下一条记录，并清掉槽位，companion 内存里不留已发出的身份
+    bool Take(IdentityRecord &out) {
+        if (s_pool == nullptr) return false;
+        std::lock_guard<std::mutex> guard(s_pool->lock);
+        if (s_pool->head == s_pool->tail) return false;
+        IdentityRecord &slot = s_pool->slots[s_pool->head++ % kPoolCapacity];
+        memcpy(&out, &slot, sizeof(out));
+        memset(&slot, 0, sizeof(slot));
+        return true;
+    }
+
+    bool WriteAll(int fd, const void *buf, size_t len) {
+        auto *p = static_cast<const uint8_t *>(buf);
+        while (len > 0) {
+            ssize_t n = TEMP_FAILURE_RETRY(write(fd, p, len));
+            if (n <= 0) return false;
+            p += n;
+            len -= size_t(n);
+        }
+        return true;
+    }
+
+    // 跨进程收到的记录：SimOperator 必须是目录中的运营商，IMSI、ICCID 与运营商名称都由同一条目派生
+    bool SimConsistent(const IdentityRecord &rec) {
+        if (memchr(rec.sim_operator, '\0', sizeof(rec.sim_operator)) == nullptr) return false;
+        const Carrier::Entry *carrier = Carrier::Find(rec.sim_operator);
+        if (carrier == nullptr) return false;
+        size_t plmn_len = 3 + carrier->mnc_digits;
+        return memcmp(rec.imsi, rec.sim_operator, plmn_len) == 0 &&
+               memcmp(rec.sim_serial, carrier->iccid_issuer, 6) == 0 &&
+               memcmp(rec.operator_name, carrier->name, sizeof(rec.operator_name)) == 0;
+    }
+
+    bool ReadAll(int fd, void *buf, size_t len) {
+        auto *p = static_cast<uint8_t *>(buf);
+        while (len > 0) {
+            ssize_t n = TEMP_FAILURE_RETRY(read(fd, p, len));
+            if (n <= 0) return false;
+            p += n;
+            len -= size_t(n);
+        }
+        return true;
+    }
+}
+
+namespace IdentityPool {
+    void ServeCompanion(int client) {
+        std::call_once(s_pool_once, CreatePool);
+        Reply reply{};
+        reply.magic = kReplyMagic;
+        reply.size = sizeof(Reply);
+        reply.ok = Take(reply.record) ? 1 : 0;
+        WriteAll(client, &reply, sizeof(reply));
+        memset(&reply.record, 0, sizeof(reply.record));
+        // 每次有进程来领取就唤醒补充线程
+        if (s_pool != nullptr) s_pool->wakeup.notify_one();
+    }
+
+    bool ClaimFromCompanion(int sock, IdentityRecord &out) {
+        Reply reply;
+        if (!ReadAll(sock, &reply, sizeof(reply))) return false;
+        if (reply.magic != kReplyMagic || reply.size != sizeof(Reply) || reply.ok != 1) return false;
+        if (!SimConsistent(reply.record)) {
+            LOGW("Identity from companion has an unknown SIM operator, ignored");
+            return false;
+        }
+        memcpy(&out, &reply.record, sizeof(out));
+        return true;
+    }
+}
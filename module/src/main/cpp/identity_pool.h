@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "identity_profile.h"
+
+// 一条完整的预生成身份：定长字段、无指针，可以原样经 socket 传给应用进程
+struct IdentityRecord {
+    uint8_t seed[IdentityProfile::kSeedSize];
+    char imei[RandUtil::kImeiLen + 1];
+    char mac[RandUtil::kMacLen + 1];
+    char android_id[RandUtil::kHexIdLen + 1];
+    char media_drm_id[RandUtil::kMediaDrmIdLen + 1];
+    char hardware_id[RandUtil::kHardwareIdMaxLen + 1];
+    char bluetooth_mac[RandUtil::kBluetoothMacLen + 1];
+    char bluetooth_name[RandUtil::kBluetoothNameMaxLen + 1];
+    // SIM 相关字段来自同一个运营商，彼此一致
+    char sim_serial[sizeof(Carrier::SimIdentity::iccid)];
+    char imsi[sizeof(Carrier::SimIdentity::imsi)];
+    char mobile[sizeof(Carrier::SimIdentity::msisdn)];
+    char sim_operator[sizeof(Carrier::SimIdentity::sim_operator)];
+    char operator_name[sizeof(Carrier::SimIdentity::operator_name)];
+};
+
+// 由种子派生出整条记录（companion 预生成与应用端兜底共用）
+inline void FillIdentityRecord(IdentityRecord &rec, const IdentityProfile &profile) {
+    IdentityProfile::Seed seed = profile.GetSeed();
+    memcpy(rec.seed, seed.data(), sizeof(rec.seed));
+    profile.IMEI(rec.imei);
+    profile.MAC(rec.mac);
+    profile.AndroidID(rec.android_id);
+    profile.MediaDrmID(rec.media_drm_id);
+    profile.HardwareID(rec.hardware_id);
+    profile.BluetoothMAC(rec.bluetooth_mac);
+    profile.BluetoothName(rec.bluetooth_name);
+
+    Carrier::SimIdentity sim;
+    profile.Sim(sim);
+    memcpy(rec.sim_serial, sim.iccid, sizeof(rec.sim_serial));
+    memcpy(rec.imsi, sim.imsi, sizeof(rec.imsi));
+    memcpy(rec.mobile, sim.msisdn, sizeof(rec.mobile));
+    memcpy(rec.sim_operator, sim.sim_operator, sizeof(rec.sim_operator));
+    memcpy(rec.operator_name, sim.operator_name, sizeof(rec.operator_name));
+}
+
+// root companion 维护的预生成身份池：companion 进程内的环形缓冲区，后台线程持续补充。
+// 应用进程只能经 socket 领到属于自己的那一条，看不到也改不了发给其它应用的身份。
+namespace IdentityPool {
+    // companion 端：处理一次连接，取出下一条记录写回应用进程（池空时只回失败）
+    void ServeCompanion(int client);
+
+    // 应用端：从 companion socket 领取一条记录，池不可用或已空时返回 false
+    bool ClaimFromCompanion(int sock, IdentityRecord &out);
+}
@@ -0,0 +1,182 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include "carrier_catalog.h"
+#include "zygisk_device_random.h"
+
+// 由一个 256 位种子确定的整套设备身份。
+// 字段 k 的第 slot 个取值 = PRF(seed, field_id, slot)，按需计算、不保存任何生成结果，
+// 整个身份可以只用 32 字节种子往返存储（农场数据库里存种子而不是字符串）。
+
+// 身份字段编号：写入 PRF 输入，数值一旦发布不可更改，否则已保存的种子会得到不同结果
+enum class IdField : uint32_t {
+    Imei = 1,
+    Mac = 2,
+    AndroidId = 3,
+    SimSerial = 4,   // ICCID
+    Mobile = 5,      // MSISDN
+    MediaDrmId = 6,
+    HardwareId = 7,
+    SimOperator = 8,
+    Carrier = 9,     // 运营商及其一致的 SimOperator / ICCID / IMSI / 手机号
+    BluetoothMac = 10,
+    BluetoothName = 11,
+};
+
+// ChaCha8 计数器模式 PRF：key = 种子，nonce = (field, slot)，counter = 块序号。
+// 输出满足 UniformRandomBitGenerator，可直接喂给 RandUtil 的定长生成器。
+class PrfStream {
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    PrfStream(const uint8_t (&key)[32], uint32_t field, uint32_t slot) : field(field), slot(slot) {
+        for (int i = 0; i < 8; i++) {
+            this->key[i] = uint32_t(key[i * 4]) | uint32_t(key[i * 4 + 1]) << 8 |
+                           uint32_t(key[i * 4 + 2]) << 16 | uint32_t(key[i * 4 + 3]) << 24;
+        }
+    }
+
+    result_type operator()() {
+        if (pos == 8) Refill();
+        return block[pos++];
+    }
+
+private:
+    uint32_t key[8];
+    uint32_t field;
+    uint32_t slot;
+    uint32_t counter = 0;
+    uint64_t block[8];
+    unsigned pos = 8;
+
+    static constexpr uint32_t Rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+    static void QuarterRound(uint32_t *x, int a, int b, int c, int d) {
+        x[a] += x[b]; x[d] = Rotl(x[d] ^ x[a], 16);
+        x[c] += x[d]; x[b] = Rotl(x[b] ^ x[c], 12);
+        x[a] += x[b]; x[d] = Rotl(x[d] ^ x[a], 8);
+        x[c] += x[d]; x[b] = Rotl(x[b] ^ x[c], 7);
+    }
+
+    void Refill() {
+        const uint32_t input[16] = {
+                0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,  // "expand 32-byte k"
+                key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+                counter++, field, slot, 0};
+        uint32_t x[16];
+        memcpy(x, input, sizeof(x));
+        for (int round = 0; round < 8; round += 2) {
+            QuarterRound(x, 0, 4, 8, 12);
+            QuarterRound(x, 1, 5, 9, 13);
+            QuarterRound(x, 2, 6, 10, 14);
+            QuarterRound(x, 3, 7, 11, 15);
+            QuarterRound(x, 0, 5, 10, 15);
+            QuarterRound(x, 1, 6, 11, 12);
+            QuarterRound(x, 2, 7, 8, 13);
+            QuarterRound(x, 3, 4, 9, 14);
+        }
+        for (int i = 0; i < 8; i++) {
+            block[i] = uint64_t(x[i * 2] + input[i * 2]) |
+                       uint64_t(x[i * 2 + 1] + input[i * 2 + 1]) << 32;
+        }
+        pos = 0;
+    }
+};
+
+class IdentityProfile {
+public:
+    static constexpr size_t kSeedSize = 32;
+    using Seed = std::array<uint8_t, kSeedSize>;
+
+    // 从当前线程随机引擎抽取新种子
+    static IdentityProfile Random() {
+        Seed seed;
+        for (size_t i = 0; i < kSeedSize; i += 8) {
+            uint64_t x = RandUtil::Engine()();
+            memcpy(seed.data() + i, &x, 8);
+        }
+        return FromSeed(seed);
+    }
+
+    static IdentityProfile FromSeed(const Seed &seed) {
+        IdentityProfile profile;
+        memcpy(profile.key, seed.data(), kSeedSize);
+        return profile;
+    }
+
+    // 序列化：整个身份就是这 32 字节
+    Seed GetSeed() const {
+        Seed seed;
+        memcpy(seed.data(), key, kSeedSize);
+        return seed;
+    }
+
+    PrfStream Stream(IdField field, uint32_t slot = 0) const {
+        return PrfStream(key, uint32_t(field), slot);
+    }
+
+    void IMEI(std::span<char, RandUtil::kImeiLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::Imei, slot);
+        RandUtil::IMEI(out, rng);
+    }
+
+    void MAC(std::span<char, RandUtil::kMacLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::Mac, slot);
+        RandUtil::MAC(out, rng);
+    }
+
+    void AndroidID(std::span<char, RandUtil::kHexIdLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::AndroidId, slot);
+        RandUtil::Hex(out, rng);
+    }
+
+    void SimSerial(std::span<char, RandUtil::kSimSerialLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::SimSerial, slot);
+        RandUtil::SimSerial(out, rng);
+    }
+
+    void Mobile(std::span<char, RandUtil::kMobileLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::Mobile, slot);
+        RandUtil::Mobile(out, rng);
+    }
+
+    void MediaDrmID(std::span<char, RandUtil::kMediaDrmIdLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::MediaDrmId, slot);
+        RandUtil::MediaDrmID(out, rng);
+    }
+
+    size_t HardwareID(std::span<char, RandUtil::kHardwareIdMaxLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::HardwareId, slot);
+        return RandUtil::HardwareID(out, rng);
+    }
+
+    void SimOperator(std::span<char, RandUtil::kSimOperatorLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::SimOperator, slot);
+        RandUtil::SimOperator(out, rng);
+    }
+
+    void BluetoothMAC(std::span<char, RandUtil::kBluetoothMacLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::BluetoothMac, slot);
+        RandUtil::BluetoothMAC(out, rng);
+    }
+
+    size_t BluetoothName(std::span<char, RandUtil::kBluetoothNameMaxLen + 1> out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::BluetoothName, slot);
+        return RandUtil::BluetoothName(out, rng);
+    }
+
+    // 一次抽取运营商，派生相互一致的 SIM 标识
+    void Sim(Carrier::SimIdentity &out, uint32_t slot = 0) const {
+        PrfStream rng = Stream(IdField::Carrier, slot);
+        Carrier::Generate(out, rng);
+    }
+
+private:
+    uint8_t key[kSeedSize];
+
+    IdentityProfile() = default;
+};
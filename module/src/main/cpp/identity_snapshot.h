@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include "identity_pool.h"
+
+// 进程级只读身份快照：preAppSpecialize 中写入一次并通过原子指针发布，
+// 之后所有线程的Hook只做一次 acquire 读取，没有线程局部状态、没有锁、没有堆分配。
+namespace IdentitySnapshot {
+    namespace detail {
+        inline constinit IdentityRecord storage{};
+        inline constinit std::atomic<const IdentityRecord *> published{nullptr};
+        // 0 = 空，1 = 正在写入 storage，2 = 已发布
+        inline constinit std::atomic<int> state{0};
+
+        // 抢到写入权的线程填充 storage 后发布；其他线程等待发布完成
+        template <typename Fill>
+        inline bool PublishWith(Fill &&fill) {
+            int expected = 0;
+            if (!state.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+                while (published.load(std::memory_order_acquire) == nullptr) std::this_thread::yield();
+                return false;
+            }
+            fill(storage);
+            published.store(&storage, std::memory_order_release);
+            state.store(2, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 发布本进程的身份，只有第一次调用生效
+    inline bool Publish(const IdentityRecord &rec) {
+        return detail::PublishWith([&](IdentityRecord &dst) { dst = rec; });
+    }
+
+    // 无等待读取；万一Hook先于发布被调用，则惰性生成并由 CAS 胜出者发布
+    inline const IdentityRecord &Get() {
+        const IdentityRecord *rec = detail::published.load(std::memory_order_acquire);
+        if (__builtin_expect(rec != nullptr, 1)) return *rec;
+        detail::PublishWith([](IdentityRecord &dst) { FillIdentityRecord(dst, IdentityProfile::Random()); });
+        return *detail::published.load(std::memory_order_acquire);
+    }
+}
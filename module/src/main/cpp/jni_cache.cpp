@@ -0,0 +1,81 @@
+#include "jni_cache.h"
+#include <atomic>
+#include "identity_snapshot.h"
+
+namespace JniCache {
+    namespace {
+        std::atomic<jstring> androidId{nullptr};
+        std::atomic<jstring> bluetoothAddress{nullptr};
+        std::atomic<jstring> bluetoothName{nullptr};
+        std::atomic<jstring> hardware{nullptr};
+        std::atomic<jstring> simOperator{nullptr};
+
+        // 把 ASCII 标识直接展开成 UTF-16，跳过 NewStringUTF 的 modified UTF-8 校验
+        template <size_t N>
+        jstring NewAsciiString(JNIEnv *env, const char (&ascii)[N]) {
+            jchar utf16[N];
+            jsize len = 0;
+            while (len < jsize(N) && ascii[len] != '\0') {
+                utf16[len] = jchar(ascii[len]);
+                len++;
+            }
+            return env->NewString(utf16, len);
+        }
+
+        // 多个线程同时首次调用时各自创建，CAS 失败的一方释放自己的全局引用；
+        // 调用方拿到的始终是新建的局部引用
+        jstring Publish(JNIEnv *env, std::atomic<jstring> &slot, jstring local) {
+            if (local == nullptr) return nullptr;
+            auto global = static_cast<jstring>(env->NewGlobalRef(local));
+            jstring expected = nullptr;
+            if (global != nullptr && !slot.compare_exchange_strong(expected, global, std::memory_order_acq_rel)) {
+                env->DeleteGlobalRef(global);
+            }
+            return local;
+        }
+
+        // 调用方（包括 PLT Hook 的原生调用者）按 JNI 约定会 DeleteLocalRef 返回值，
+        // 所以每次返回全局引用的一个局部引用；NewLocalRef 只占局部引用表的一项，不分配对象
+        template <size_t N>
+        jstring Cached(JNIEnv *env, std::atomic<jstring> &slot, const char (&ascii)[N]) {
+            jstring cached = slot.load(std::memory_order_acquire);
+            if (__builtin_expect(cached != nullptr, 1)) return static_cast<jstring>(env->NewLocalRef(cached));
+            return Publish(env, slot, NewAsciiString(env, ascii));
+        }
+    }
+
+    jstring AndroidId(JNIEnv *env) {
+        return Cached(env, androidId, IdentitySnapshot::Get().android_id);
+    }
+
+    jstring BluetoothAddress(JNIEnv *env) {
+        return Cached(env, bluetoothAddress, IdentitySnapshot::Get().bluetooth_mac);
+    }
+
+    jstring BluetoothName(JNIEnv *env) {
+        return Cached(env, bluetoothName, IdentitySnapshot::Get().bluetooth_name);
+    }
+
+    jstring Hardware(JNIEnv *env) {
+        return Cached(env, hardware, IdentitySnapshot::Get().hardware_id);
+    }
+
+    jstring SimOperator(JNIEnv *env) {
+        return Cached(env, simOperator, IdentitySnapshot::Get().sim_operator);
+    }
+
+    jbyteArray MediaDrmId(JNIEnv *env) {
+        // 快照里的定长字段就是模板：位于本地内存，不受 GC 移动影响，复制只需一次 SetByteArrayRegion
+        const auto &tmpl = IdentitySnapshot::Get().media_drm_id;
+        constexpr jsize kLen = sizeof(tmpl) - 1;
+        jbyteArray arr = env->NewByteArray(kLen);
+        if (arr != nullptr) env->SetByteArrayRegion(arr, 0, kLen, reinterpret_cast<const jbyte *>(tmpl));
+        return arr;
+    }
+
+    void Release(JNIEnv *env) {
+        for (std::atomic<jstring> *slot : {&androidId, &bluetoothAddress, &bluetoothName, &hardware, &simOperator}) {
+            if (jstring cached = slot->exchange(nullptr, std::memory_order_acq_rel)) env->DeleteGlobalRef(cached);
+        }
+    }
+}
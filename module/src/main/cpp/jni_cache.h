@@ -0,0 +1,22 @@
+#pragma once
+#include <jni.h>
+
+// 伪造结果的 JNI 对象缓存。
+// 身份快照发布后不再变化，所以 Settings 返回的 jstring 只需创建一次并保存为全局引用，
+// 之后每次查询返回指向同一个对象的新局部引用（Java 字符串不可变，共享是安全的）。
+// byte[] 是可变的，不能把同一个数组交给调用方，只能每次从预先准备好的模板复制一份。
+namespace JniCache {
+    // 各字符串的局部引用，对象在首次调用时由 UTF-16 缓冲区经 NewString 创建并缓存为全局引用
+    jstring AndroidId(JNIEnv *env);
+    jstring BluetoothAddress(JNIEnv *env);
+    jstring BluetoothName(JNIEnv *env);
+    // SystemProperties.native_get 返回的属性值
+    jstring Hardware(JNIEnv *env);
+    jstring SimOperator(JNIEnv *env);
+
+    // MediaDrm 唯一 ID：从模板复制出一个新数组
+    jbyteArray MediaDrmId(JNIEnv *env);
+
+    // 释放缓存的全局引用（宿主机测试在销毁 JNIEnv 前调用）
+    void Release(JNIEnv *env);
+}
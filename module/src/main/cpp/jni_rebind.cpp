@@ -0,0 +1,119 @@
+#include "jni_rebind.h"
+#include "device_hooks.h"
+#include "log.h"
+
+namespace JniRebind {
+    namespace {
+        // 只在 preAppSpecialize（单线程）中写入
+        jclass classes[JniTable::kClassCount];
+        jmethodID methods[JniTable::kCount];
+
+        // 方法下标 -> 所属类下标
+        constexpr auto kClassOf = [] {
+            std::array<uint8_t, JniTable::kCount> classOf{};
+            for (size_t c = 0; c < JniTable::kClassCount; c++) {
+                for (size_t i = JniTable::kClasses[c].begin; i < JniTable::kClasses[c].end; i++) classOf[i] = uint8_t(c);
+            }
+            return classOf;
+        }();
+
+        jclass FindClass(JNIEnv *env, size_t c) {
+            if (classes[c] != nullptr) return classes[c];
+            jclass local = env->FindClass(JniTable::kClasses[c].name);
+            if (local == nullptr) {
+                env->ExceptionClear();
+                return nullptr;
+            }
+            classes[c] = static_cast<jclass>(env->NewGlobalRef(local));
+            env->DeleteLocalRef(local);
+            return classes[c];
+        }
+
+        jmethodID FindMethod(JNIEnv *env, jclass clazz, size_t i) {
+            if (methods[i] != nullptr) return methods[i];
+            const JniTable::Method &m = JniTable::kMethods[i];
+            jmethodID id = m.kind == JniKind::Static ? env->GetStaticMethodID(clazz, m.name, m.signature)
+                                                     : env->GetMethodID(clazz, m.name, m.signature);
+            if (id == nullptr) env->ExceptionClear();
+            methods[i] = id;
+            return id;
+        }
+    }
+
+    void Rebind(JNIEnv *env, HookNatives hook, void *ctx, Result &result) {
+        result.rebound = 0;
+        result.skipped = 0;
+        for (size_t c = 0; c < JniTable::kClassCount; c++) {
+            const JniTable::Class &cls = JniTable::kClasses[c];
+            jclass clazz = FindClass(env, c);
+
+            // 本类中确认存在的方法凑成一批，batch[k] 对应表下标 index[k]
+            JNINativeMethod batch[JniTable::kMaxPerClass];
+            uint8_t index[JniTable::kMaxPerClass];
+            int count = 0;
+            for (size_t i = cls.begin; i < cls.end; i++) {
+                if (clazz == nullptr) {
+                    result.status[i] = Status::NoClass;
+                } else if (FindMethod(env, clazz, i) == nullptr) {
+                    result.status[i] = Status::NoMethod;
+                } else {
+                    const JniTable::Method &m = JniTable::kMethods[i];
+                    batch[count] = {m.name, m.signature, DeviceHooks::kJniBindings[i].handler};
+                    index[count++] = uint8_t(i);
+                }
+            }
+            if (count > 0) hook(ctx, env, cls.name, batch, count);
+
+            for (int k = 0; k < count; k++) {
+                size_t i = index[k];
+                const DeviceHooks::Binding &binding = DeviceHooks::kJniBindings[i];
+                void *orig = batch[k].fnPtr;
+                if (orig == nullptr) {
+                    result.status[i] = Status::NotRegistered;
+                    continue;
+                }
+                // 重复调用时换回的是我们自己的 handler，原指针保持第一次的值，避免自我递归
+                if (orig != binding.handler) *binding.orig = orig;
+                result.status[i] = Status::Rebound;
+            }
+        }
+
+        for (size_t i = 0; i < JniTable::kCount; i++) {
+            if (result.status[i] == Status::Rebound) {
+                result.rebound++;
+                continue;
+            }
+            result.skipped++;
+            LOGW("Skip JNI rebind %s.%s%s: %s", JniTable::kMethods[i].clazz, JniTable::kMethods[i].name,
+                 JniTable::kMethods[i].signature, StatusName(result.status[i]));
+        }
+    }
+
+    jclass Class(HookId id) {
+        size_t i = JniTable::Index(id);
+        return i < JniTable::kCount ? classes[kClassOf[i]] : nullptr;
+    }
+
+    jmethodID Method(HookId id) {
+        size_t i = JniTable::Index(id);
+        return i < JniTable::kCount ? methods[i] : nullptr;
+    }
+
+    const char *StatusName(Status status) {
+        switch (status) {
+            case Status::Rebound: return "rebound";
+            case Status::NoClass: return "class not found";
+            case Status::NoMethod: return "method not found";
+            case Status::NotRegistered: return "no registered native";
+        }
+        return "?";
+    }
+
+    void Release(JNIEnv *env) {
+        for (jclass &clazz : classes) {
+            if (clazz != nullptr) env->DeleteGlobalRef(clazz);
+            clazz = nullptr;
+        }
+        for (jmethodID &id : methods) id = nullptr;
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <jni.h>
+#include <cstdint>
+#include "jni_table.h"
+
+// JNI native 方法重绑定：按 jni_table.h 逐类批量替换 native 函数指针。
+// 每个类只 FindClass 一次并保存全局引用，方法先用 Get(Static)MethodID 确认存在，
+// 存在的方法凑成一批交给一次 hookJniNativeMethods（ART 里就是每个方法一次入口指针写入），
+// 不像 PLT Hook 那样在 commit 时扫描所有已加载库。
+namespace JniRebind {
+    enum class Status : uint8_t {
+        Rebound,        // 已替换，原函数指针存入 orig 槽
+        NoClass,        // FindClass 失败
+        NoMethod,       // 类中没有这个名字与签名的方法
+        NotRegistered,  // 方法存在但没有已注册的 native 实现（hookJniNativeMethods 返回 nullptr）
+    };
+
+    struct Result {
+        Status status[JniTable::kCount];
+        uint32_t rebound;
+        uint32_t skipped;
+    };
+
+    // hookJniNativeMethods 的调用入口：模块中转发给 zygisk::Api，宿主机上由 FakeJniEnv 模拟。
+    // 语义与 Zygisk 一致：找到的方法替换为 fnPtr 并把原指针写回 fnPtr，找不到的 fnPtr 置为 nullptr
+    using HookNatives = void (*)(void *ctx, JNIEnv *env, const char *clazz, JNINativeMethod *methods, int count);
+
+    // 逐类重绑定；可重复调用，已缓存的类与方法不再查找，已替换的方法保留第一次拿到的原指针
+    void Rebind(JNIEnv *env, HookNatives hook, void *ctx, Result &result);
+
+    // 缓存的类全局引用与方法 ID（未找到时为 nullptr）
+    jclass Class(HookId id);
+    jmethodID Method(HookId id);
+
+    const char *StatusName(Status status);
+
+    // 释放类的全局引用并清空缓存（宿主机测试在销毁 JNIEnv 前调用）
+    void Release(JNIEnv *env);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "hook_ids.h"
+#include "hook_table.h"
+
+// 声明式 JNI 重绑定表：行定义在 hook_defs.h 的 RANDOMID_JNI_TABLE 中。
+
+enum class JniKind : uint8_t {
+    Static,
+    Instance,
+};
+
+namespace JniTable {
+    struct Method {
+        HookId id;
+        const char *clazz;
+        const char *name;
+        const char *signature;
+        JniKind kind;
+    };
+
+    inline constexpr Method kMethods[] = {
+#define X(id, num, type, clazz, name, signature, kind, events) {HookId::id, clazz, name, signature, kind},
+            RANDOMID_JNI_TABLE(X)
+#undef X
+    };
+
+    inline constexpr size_t kCount = std::size(kMethods);
+
+    // HookId -> 表内下标，不是 JNI 重绑定的 Hook 返回 kCount
+    inline constexpr size_t Index(HookId id) {
+        for (size_t i = 0; i < kCount; i++) {
+            if (kMethods[i].id == id) return i;
+        }
+        return kCount;
+    }
+
+    // 一个类对应 kMethods 中连续的一段 [begin, end)
+    struct Class {
+        const char *name;
+        uint8_t begin;
+        uint8_t end;
+    };
+
+    inline constexpr size_t kClassCount = [] {
+        size_t classes = 0;
+        for (size_t i = 0; i < kCount; i++) {
+            if (i == 0 || HookTable::detail::Compare(kMethods[i - 1].clazz, kMethods[i].clazz) != 0) classes++;
+        }
+        return classes;
+    }();
+
+    inline constexpr auto kClasses = [] {
+        std::array<Class, kClassCount> classes{};
+        size_t c = 0;
+        for (size_t i = 0; i < kCount; i++) {
+            if (c == 0 || HookTable::detail::Compare(classes[c - 1].name, kMethods[i].clazz) != 0) {
+                classes[c++] = {kMethods[i].clazz, uint8_t(i), uint8_t(i + 1)};
+            } else {
+                classes[c - 1].end = uint8_t(i + 1);
+            }
+        }
+        return classes;
+    }();
+
+    static_assert([] {
+        for (size_t a = 0; a < kClassCount; a++) {
+            for (size_t b = a + 1; b < kClassCount; b++) {
+                if (HookTable::detail::Compare(kClasses[a].name, kClasses[b].name) == 0) return false;
+            }
+        }
+        return true;
+    }(), "JNI 表中同一个类的行必须相邻");
+
+    // 单个类最多的方法数，决定每批 JNINativeMethod 数组的大小
+    inline constexpr size_t kMaxPerClass = [] {
+        size_t max = 0;
+        for (const Class &c : kClasses) max = size_t(c.end - c.begin) > max ? size_t(c.end - c.begin) : max;
+        return max;
+    }();
+}
@@ -1,14 +1,39 @@
-
-
 #ifndef ZYGISK_RANDOMID_LOG_H
 #define ZYGISK_RANDOMID_LOG_H
 
 #include <android/log.h>
+#include "async_log.h"
 
 #define LOG_TAG "DifierLine"
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 
-#endif 
+// 编译期日志级别（与 android_LogPriority 数值一致：3=DEBUG 4=INFO 5=WARN 6=ERROR 8=SILENT），
+// 低于该级别的调用连同参数求值一起被去除。由 CMake 的 RANDOMID_LOG_LEVEL 设置。
+#ifndef RANDOMID_LOG_LEVEL
+#define RANDOMID_LOG_LEVEL 3
+#endif
+
+#if RANDOMID_LOG_LEVEL <= 3
+#define LOGD(...) AsyncLog::Write(ANDROID_LOG_DEBUG, __VA_ARGS__)
+#else
+#define LOGD(...) ((void)0)
+#endif
+
+#if RANDOMID_LOG_LEVEL <= 4
+#define LOGI(...) AsyncLog::Write(ANDROID_LOG_INFO, __VA_ARGS__)
+#else
+#define LOGI(...) ((void)0)
+#endif
+
+#if RANDOMID_LOG_LEVEL <= 5
+#define LOGW(...) AsyncLog::Write(ANDROID_LOG_WARN, __VA_ARGS__)
+#else
+#define LOGW(...) ((void)0)
+#endif
+
+#if RANDOMID_LOG_LEVEL <= 6
+#define LOGE(...) AsyncLog::Write(ANDROID_LOG_ERROR, __VA_ARGS__)
+#else
+#define LOGE(...) ((void)0)
+#endif
+
+#endif
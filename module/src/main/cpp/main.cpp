@@ -1,4 +1,14 @@
 #include "zygisk_device_random.h"
+#include "identity_pool.h"
+#include "device_hooks.h"
+#include "cycle_clock.h"
+#include "got_patch.h"
+#include "hook_resolver.h"
+#include "jni_rebind.h"
+#include "symbol_cache.h"
+#include "hook_stats.h"
+#include "hook_trace.h"
+#include "xdl.h"
 #include <cstring>
 #include <thread>
 #include <fcntl.h>
@@ -18,6 +28,9 @@ struct ZygiskModule : zygisk::ModuleBase {
         this->api = api;
         this->env = env;
         this->target_pkg = "com.example.game";
+        // Zygisk 在 fork 出的子进程里加载模块，onLoad 与 preAppSpecialize 在同一个进程中先后执行，
+        // 并不只在 zygote 里跑一次；在这里做解析只会拖慢每个非目标应用。
+        // 跨进程复用的解析结果（含 GOT 槽偏移）由 SymbolCache 持久化，目标应用只需查表并改写槽
         LOGI("Zygisk module loaded, waiting for app specialize");
     }
 
@@ -30,138 +43,83 @@ struct ZygiskModule : zygisk::ModuleBase {
             return;
         }
         LOGI("Load for target process: %s", pkg);
+        [[maybe_unused]] uint64_t specializeStart = CycleClock::MonotonicNs();
+        // 模块目录只在 preAppSpecialize 中可写，在这里创建并映射追踪与统计文件，并载入符号解析缓存
+        HookTrace::Open(api->getModuleDir(), pkg);
+        HookStats::Open(api->getModuleDir(), pkg);
+        SymbolCache::Open(api->getModuleDir());
         env->ReleaseStringUTFChars(args->nice_name, pkg);
+        is_target = true;
+
+        // 领取本进程使用的身份（优先来自 companion 预生成池）
+        claimIdentity();
 
         // 执行设备标识Hook（改用Zygisk pltHook）
+        // 解析时回退到 .gnu_debugdata 的库只在首次（每次 OTA 后）解压，之后映射 cache/ 中按 build-id 存放的符号索引
         LOGI("Start device ID randomization hook");
+        int xdlCache = SymbolCache::OpenDir();
+        xdl_set_cache_dir(xdlCache);
         hookAllDeviceIds();
+        xdl_set_cache_dir(-1);
+        if (xdlCache >= 0) close(xdlCache);
+
+        // Java 直接调用的 native 方法不经过 PLT，改为替换已注册的 JNI 函数指针
+        rebindJniNatives();
+        LOGI("Target specialize took %.3f ms", double(CycleClock::MonotonicNs() - specializeStart) / 1e6);
+    }
+
+    void postAppSpecialize(const zygisk::AppSpecializeArgs *args) override {
+        // 已离开 zygote，可以创建后台日志线程
+        if (is_target) AsyncLog::Start();
     }
 
 private:
     zygisk::Api *api;
     JNIEnv *env;
     std::string target_pkg;
-
-    // 2. 所有Hook原函数指针加static（解决静态函数访问问题）
-    // IMEI相关
-    using GetDeviceIdFunc = const char* (*)(JNIEnv*, jobject);
-    static GetDeviceIdFunc origGetDeviceId;
-
-    using GetImeiFunc = const char* (*)(JNIEnv*, jobject, int);
-    static GetImeiFunc origGetImei;
-
-    // MAC相关
-    using GetMacAddrFunc = const char* (*)(JNIEnv*, jobject);
-    static GetMacAddrFunc origGetMacAddr;
-
-    // Android ID相关
-    using GetSettingsStringFunc = jstring (*)(JNIEnv*, jobject, jobject, jstring);
-    static GetSettingsStringFunc origGetSettingsString;
-
-    // Hardware ID相关
-    using GetHardwareFunc = const char* (*)();
-    static GetHardwareFunc origGetHardware;
-
-    // 手机号相关
-    using GetLine1NumberFunc = const char* (*)(JNIEnv*, jobject);
-    static GetLine1NumberFunc origGetLine1Number;
-
-    // Sim相关
-    using GetSimSerialFunc = const char* (*)(JNIEnv*, jobject);
-    static GetSimSerialFunc origGetSimSerial;
-
-    using GetSimOperatorFunc = const char* (*)(JNIEnv*, jobject);
-    static GetSimOperatorFunc origGetSimOperator;
-
-    // MediaDrm相关
-    using GetMediaDrmUniqueIdFunc = jbyteArray (*)(JNIEnv*, jobject);
-    static GetMediaDrmUniqueIdFunc origGetMediaDrmUniqueId;
-
-    // 3. 核心修改：用Zygisk pltHook替代xdl_hook_symbol（无第三方依赖）
-    template <typename T>
-    void hookSymbol(const char* libRegex, const char* symName, T hookFunc, T* origFunc) {
-        // 注册PLT Hook：参数1=库正则（精确匹配），参数2=函数名，参数3=新函数，参数4=保存原函数地址
-        api->pltHookRegister(libRegex, symName, (void*)hookFunc, (void**)origFunc);
-        LOGI("Registered Hook: %s -> %s", libRegex, symName);
-    }
-
-    // 4. 各设备标识Hook实现（逻辑不变，适配static指针）
-    static const char* hookGetDeviceId(JNIEnv* env, jobject thiz) {
-        static thread_local std::string cache = RandUtil::IMEI();
-        LOGI("Return random IMEI: %s", cache.c_str());
-        return cache.c_str();
-    }
-
-    static const char* hookGetImei(JNIEnv* env, jobject thiz, int slot) {
-        static thread_local std::string cache = RandUtil::IMEI();
-        LOGI("Return random IMEI (slot %d): %s", slot, cache.c_str());
-        return cache.c_str();
-    }
-
-    static const char* hookGetMacAddr(JNIEnv* env, jobject thiz) {
-        static thread_local std::string cache = RandUtil::MAC();
-        LOGI("Return random MAC: %s", cache.c_str());
-        return cache.c_str();
-    }
-
-    static jstring hookGetSettingsString(JNIEnv* env, jobject thiz, jobject contentResolver, jstring key) {
-        const char* keyStr = env->GetStringUTFChars(key, nullptr);
-        if (keyStr && strcmp(keyStr, "android_id") == 0) {
-            std::string androidId = RandUtil::Hex(16);
-            LOGI("Return random Android ID: %s", androidId.c_str());
-            env->ReleaseStringUTFChars(key, keyStr);
-            return env->NewStringUTF(androidId.c_str());
-        }
-        env->ReleaseStringUTFChars(key, keyStr);
-        // 引用static原函数指针，无访问错误
-        return origGetSettingsString(env, thiz, contentResolver, key);
-    }
-
-    static const char* hookGetHardware() {
-        static thread_local std::string cache = RandUtil::HardwareID();
-        LOGI("Return random Hardware ID: %s", cache.c_str());
-        return cache.c_str();
-    }
-
-    static const char* hookGetLine1Number(JNIEnv* env, jobject thiz) {
-        static thread_local std::string cache = RandUtil::Mobile();
-        LOGI("Return random Mobile No: %s", cache.c_str());
-        return cache.c_str();
-    }
-
-    static const char* hookGetSimSerial(JNIEnv* env, jobject thiz) {
-        static thread_local std::string cache = RandUtil::SimSerial();
-        LOGI("Return random Sim Serial: %s", cache.c_str());
-        return cache.c_str();
+    bool is_target = false;
+
+    // 1. 身份来源：companion 预生成池，取不到时本地由随机种子生成
+    void claimIdentity() {
+        IdentityRecord rec;
+        int sock = api->connectCompanion();
+        bool pooled = sock >= 0 && IdentityPool::ClaimFromCompanion(sock, rec);
+        if (sock >= 0) close(sock);
+        if (!pooled) FillIdentityRecord(rec, IdentityProfile::Random());
+        // 发布为进程级快照，之后所有线程读到的都是同一份身份
+        IdentitySnapshot::Publish(rec);
+        LOGI("Identity claimed from %s", pooled ? "companion pool" : "local generator");
     }
 
-    static const char* hookGetSimOperator(JNIEnv* env, jobject thiz) {
-        static thread_local std::string cache = RandUtil::SimOperator();
-        LOGI("Return random Sim Operator: %s", cache.c_str());
-        return cache.c_str();
-    }
-
-    static jbyteArray hookGetMediaDrmUniqueId(JNIEnv* env, jobject thiz) {
-        std::string drmId = RandUtil::MediaDrmID();
-        LOGI("Return random MediaDrm ID: %s", drmId.c_str());
-        jbyteArray arr = env->NewByteArray(drmId.size());
-        env->SetByteArrayRegion(arr, 0, drmId.size(), (const jbyte*)drmId.c_str());
-        return arr;
-    }
-
-    // 5. 统一注册所有Hook并提交（Zygisk pltHook需commit才生效）
+    // 2. 按 hook_table.h 生成的分组注册：同一个库的符号连续注册，库正则每组只取一次。
+    //    注册前先检查导入方是否真的引用了目标符号，不存在的目标直接丢弃，减少 commit 的扫描量
     void hookAllDeviceIds() {
-        // 批量注册Hook（库正则精确匹配，避免误Hook）
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android19TelephonyManager_getDeviceIdEP7_JNIEnvP8_jobject", hookGetDeviceId, &origGetDeviceId);
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android17TelephonyManager_getImeiEP7_JNIEnvP8_jobjecti", hookGetImei, &origGetImei);
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android13WifiInfo_getMacAddressEP7_JNIEnvP8_jobject", hookGetMacAddr, &origGetMacAddr);
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android11WifiInfo_getBssidEP7_JNIEnvP8_jobject", hookGetMacAddr, &origGetMacAddr);
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android17Settings_Secure_getStringEP7_JNIEnvP8_jobjectP8_jobjectP8_jstring", hookGetSettingsString, &origGetSettingsString);
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android5Build_getHardwareEv", hookGetHardware, &origGetHardware);
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android23TelephonyManager_getLine1NumberEP7_JNIEnvP8_jobject", hookGetLine1Number, &origGetLine1Number);
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android25TelephonyManager_getSimSerialNumberEP7_JNIEnvP8_jobject", hookGetSimSerial, &origGetSimSerial);
-        hookSymbol("^libandroid_runtime.so$", "_ZN7android24TelephonyManager_getSimOperatorEP7_JNIEnvP8_jobject", hookGetSimOperator, &origGetSimOperator);
-        hookSymbol("^libmediadrm.so$", "_ZN7android7MediaDrm11getUniqueIdEP7_JNIEnvP8_jobject", hookGetMediaDrmUniqueId, &origGetMediaDrmUniqueId);
+        HookResolver::Result resolved;
+        HookResolver::Resolve(resolved);
+        LOGI("Hook targets: %u registered, %u dropped (symbol cache %u hits, %u misses)", resolved.registered,
+             resolved.dropped, resolved.cache_hits, resolved.cache_misses);
+        // 新解析的结果写回模块目录，此后任何目标应用启动都直接命中
+        if (resolved.cache_misses > 0) SymbolCache::Flush();
+        if (resolved.registered == 0) return;
+
+        // 定位到唯一 GOT 槽的目标直接改写；其余（压缩重定位、多处引用）仍注册给 Zygisk
+        unsigned patched = 0, registered = 0;
+        for (const HookTable::Group &group : HookTable::kGroups) {
+            for (size_t i = group.begin; i < group.end; i++) {
+                size_t id = HookTable::kOrder[i];
+                if (!HookResolver::ShouldRegister(resolved.status[id])) continue;
+                const DeviceHooks::Binding &binding = DeviceHooks::kBindings[id];
+                if (resolved.slot[id] != 0 &&
+                    GotPatch::Apply(resolved.slot[id], resolved.slot_relro[id], binding.handler, binding.orig)) {
+                    patched++;
+                    continue;
+                }
+                api->pltHookRegister(group.library, HookTable::kTargets[id].symbol, binding.handler, binding.orig);
+                registered++;
+            }
+        }
+        LOGI("Device ID hooks: %u GOT slots patched directly, %u registered as PLT hooks", patched, registered);
+        if (registered == 0) return;
 
         // 提交所有Hook（关键步骤，未提交则Hook不生效）
         bool commitOk = api->pltHookCommit();
@@ -171,18 +129,19 @@ private:
             LOGE("Failed to commit device ID hooks");
         }
     }
+
+    // 3. JNI native 方法按 jni_table.h 逐类重绑定，每个类一次 hookJniNativeMethods
+    static void hookJniNatives(void *ctx, JNIEnv *env, const char *clazz, JNINativeMethod *methods, int count) {
+        static_cast<zygisk::Api *>(ctx)->hookJniNativeMethods(env, clazz, methods, count);
+    }
+
+    void rebindJniNatives() {
+        JniRebind::Result result;
+        JniRebind::Rebind(env, hookJniNatives, api, result);
+        LOGI("JNI natives: %u rebound, %u skipped", result.rebound, result.skipped);
+    }
 };
 
-// 6. 静态原函数指针初始化（C++必做，否则链接错误）
-ZygiskModule::GetDeviceIdFunc ZygiskModule::origGetDeviceId = nullptr;
-ZygiskModule::GetImeiFunc ZygiskModule::origGetImei = nullptr;
-ZygiskModule::GetMacAddrFunc ZygiskModule::origGetMacAddr = nullptr;
-ZygiskModule::GetSettingsStringFunc ZygiskModule::origGetSettingsString = nullptr;
-ZygiskModule::GetHardwareFunc ZygiskModule::origGetHardware = nullptr;
-ZygiskModule::GetLine1NumberFunc ZygiskModule::origGetLine1Number = nullptr;
-ZygiskModule::GetSimSerialFunc ZygiskModule::origGetSimSerial = nullptr;
-ZygiskModule::GetSimOperatorFunc ZygiskModule::origGetSimOperator = nullptr;
-ZygiskModule::GetMediaDrmUniqueIdFunc ZygiskModule::origGetMediaDrmUniqueId = nullptr;
-
-// 7. 注册Zygisk模块（API v2标准宏）
+// 4. 注册Zygisk模块与root companion（API v2标准宏）
 REGISTER_ZYGISK_MODULE(ZygiskModule);
+REGISTER_ZYGISK_COMPANION(IdentityPool::ServeCompanion);
@@ -0,0 +1,239 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "id_format.h"
+
+// 内嵌的 IEEE OUI（MAC 前 24 位厂商前缀）精简表，用于生成“真实厂商”的 MAC 地址。
+// 源表按厂商分组手工维护（摘自 IEEE oui.csv 中主流安卓手机厂商的注册项）；
+// 排序后的查找表、按厂商分组的索引以及厂商权重的别名表全部在编译期生成，
+// 运行时只有只读常量（约 1 KB），查找为无分支二分，按厂商加权抽样为 O(1)。
+namespace Oui {
+    enum class Vendor : uint8_t {
+        Samsung,
+        Xiaomi,
+        Bbk,      // OPPO / OnePlus
+        Huawei,
+        Google,
+        Other,    // LG / Sony / Motorola
+        kCount,
+    };
+
+    inline constexpr size_t kVendorCount = size_t(Vendor::kCount);
+
+    // 各厂商被选中的相对权重
+    inline constexpr uint32_t kVendorWeights[kVendorCount] = {30, 20, 20, 15, 5, 10};
+
+    namespace detail {
+        struct Entry {
+            uint32_t oui;
+            Vendor vendor;
+        };
+
+        using V = Vendor;
+        inline constexpr Entry kSource[] = {
+                // Samsung Electronics
+                {0x0000F0, V::Samsung}, {0x0007AB, V::Samsung}, {0x001247, V::Samsung}, {0x0012FB, V::Samsung},
+                {0x001377, V::Samsung}, {0x001599, V::Samsung}, {0x0015B9, V::Samsung}, {0x001632, V::Samsung},
+                {0x00166B, V::Samsung}, {0x00166C, V::Samsung}, {0x0016DB, V::Samsung}, {0x0017C9, V::Samsung},
+                {0x0017D5, V::Samsung}, {0x0018AF, V::Samsung}, {0x001A8A, V::Samsung}, {0x001B98, V::Samsung},
+                {0x001C43, V::Samsung}, {0x001D25, V::Samsung}, {0x001DF6, V::Samsung}, {0x001E7D, V::Samsung},
+                {0x001FCC, V::Samsung}, {0x001FCD, V::Samsung}, {0x002119, V::Samsung}, {0x00214C, V::Samsung},
+                {0x0021D1, V::Samsung}, {0x0021D2, V::Samsung}, {0x002339, V::Samsung}, {0x00233A, V::Samsung},
+                {0x002399, V::Samsung}, {0x0023D6, V::Samsung}, {0x0023D7, V::Samsung}, {0x002454, V::Samsung},
+                {0x002490, V::Samsung}, {0x002491, V::Samsung}, {0x0024E9, V::Samsung}, {0x002566, V::Samsung},
+                {0x002567, V::Samsung}, {0x002637, V::Samsung}, {0x3423BA, V::Samsung}, {0x38AA3C, V::Samsung},
+                {0x5001BB, V::Samsung}, {0x5C0A5B, V::Samsung}, {0x7825AD, V::Samsung}, {0x8425DB, V::Samsung},
+                {0x88329B, V::Samsung}, {0x8C7712, V::Samsung}, {0x94350A, V::Samsung}, {0xA00BBA, V::Samsung},
+                {0xB407F9, V::Samsung}, {0xBC72B1, V::Samsung}, {0xC44202, V::Samsung}, {0xCC07AB, V::Samsung},
+                {0xD022BE, V::Samsung}, {0xE4121D, V::Samsung}, {0xF025B7, V::Samsung}, {0xF409D8, V::Samsung},
+                // Xiaomi Communications
+                {0x009EC8, V::Xiaomi}, {0x0C1DAF, V::Xiaomi}, {0x102AB3, V::Xiaomi}, {0x14F65A, V::Xiaomi},
+                {0x185936, V::Xiaomi}, {0x2082C0, V::Xiaomi}, {0x286C07, V::Xiaomi}, {0x28E31F, V::Xiaomi},
+                {0x3480B3, V::Xiaomi}, {0x34CE00, V::Xiaomi}, {0x38A4ED, V::Xiaomi}, {0x3CBD3E, V::Xiaomi},
+                {0x4C49E3, V::Xiaomi}, {0x50642B, V::Xiaomi}, {0x584498, V::Xiaomi}, {0x640980, V::Xiaomi},
+                {0x64B473, V::Xiaomi}, {0x68DFDD, V::Xiaomi}, {0x742344, V::Xiaomi}, {0x7451BA, V::Xiaomi},
+                {0x7802F8, V::Xiaomi}, {0x7C1DD9, V::Xiaomi}, {0x8CBEBE, V::Xiaomi}, {0x98FAE3, V::Xiaomi},
+                {0x9C99A0, V::Xiaomi}, {0xA086C6, V::Xiaomi}, {0xACC1EE, V::Xiaomi}, {0xB0E235, V::Xiaomi},
+                {0xC40BCB, V::Xiaomi}, {0xD4970B, V::Xiaomi}, {0xF0B429, V::Xiaomi}, {0xF48B32, V::Xiaomi},
+                {0xF8A45F, V::Xiaomi}, {0xFC64BA, V::Xiaomi},
+                // OPPO / OnePlus
+                {0x1C77F6, V::Bbk}, {0x2C5BB8, V::Bbk}, {0x4C189A, V::Bbk}, {0x88D50C, V::Bbk},
+                {0xA43D78, V::Bbk}, {0xE8BBA8, V::Bbk}, {0x64A2F9, V::Bbk}, {0x94652D, V::Bbk},
+                {0xC0EEFB, V::Bbk},
+                // Huawei Technologies
+                {0x001882, V::Huawei}, {0x001E10, V::Huawei}, {0x002568, V::Huawei}, {0x00259E, V::Huawei},
+                {0x00464B, V::Huawei}, {0x00664B, V::Huawei}, {0x00E0FC, V::Huawei}, {0x04C06F, V::Huawei},
+                {0x04F938, V::Huawei}, {0x0819A6, V::Huawei}, {0x087A4C, V::Huawei}, {0x0C37DC, V::Huawei},
+                {0x101B54, V::Huawei}, {0x20F3A3, V::Huawei}, {0x240995, V::Huawei}, {0x283152, V::Huawei},
+                {0x286ED4, V::Huawei}, {0x346BD3, V::Huawei}, {0x4846FB, V::Huawei}, {0x4C1FCC, V::Huawei},
+                {0x548998, V::Huawei}, {0x5C7D5E, V::Huawei}, {0x70723C, V::Huawei}, {0x80B686, V::Huawei},
+                {0x80FB06, V::Huawei}, {0xACE215, V::Huawei}, {0xC8D15E, V::Huawei}, {0xD46AA8, V::Huawei},
+                {0xE0247F, V::Huawei}, {0xF4C714, V::Huawei},
+                // Google
+                {0x001A11, V::Google}, {0x3C5AB4, V::Google}, {0x546009, V::Google}, {0xA47733, V::Google},
+                {0xF4F5D8, V::Google}, {0xF4F5E8, V::Google}, {0xF88FCA, V::Google},
+                // LG Electronics
+                {0x001C62, V::Other}, {0x001E75, V::Other}, {0x001F6B, V::Other}, {0x001FE3, V::Other},
+                {0x0021FB, V::Other}, {0x0022A9, V::Other}, {0x002483, V::Other}, {0x0025E5, V::Other},
+                {0x0026E2, V::Other}, {0x10683F, V::Other}, {0x2C54CF, V::Other}, {0x40B0FA, V::Other},
+                {0x58A2B5, V::Other}, {0x64899A, V::Other}, {0x88C9D0, V::Other}, {0xA039F7, V::Other},
+                {0xC4438F, V::Other}, {0xF80CF3, V::Other},
+                // Sony Mobile Communications
+                {0x000AD9, V::Other}, {0x000E07, V::Other}, {0x000FDE, V::Other}, {0x0012EE, V::Other},
+                {0x001620, V::Other}, {0x0016B8, V::Other}, {0x001813, V::Other}, {0x001963, V::Other},
+                {0x001A75, V::Other}, {0x001B59, V::Other}, {0x001CA4, V::Other}, {0x001D28, V::Other},
+                {0x001E45, V::Other}, {0x001FE4, V::Other}, {0x00219E, V::Other}, {0x002298, V::Other},
+                {0x002345, V::Other}, {0x0023F1, V::Other}, {0x0024EF, V::Other}, {0x0025E7, V::Other},
+                {0x303926, V::Other}, {0x584822, V::Other}, {0x8400D2, V::Other},
+                // Motorola Mobility
+                {0x40786A, V::Other}, {0x5C5188, V::Other}, {0x60BEB5, V::Other}, {0x806C1B, V::Other},
+                {0x9CD917, V::Other}, {0xF8F1B6, V::Other},
+        };
+
+        inline constexpr size_t kCount = std::size(kSource);
+        static_assert(kCount < 65536);
+
+        // 打包键：高 24 位 OUI，低 8 位厂商编号；按键排序后即按 OUI 排序
+        inline constexpr auto kKeys = [] {
+            std::array<uint32_t, kCount> keys{};
+            for (size_t i = 0; i < kCount; i++) keys[i] = kSource[i].oui << 8 | uint32_t(kSource[i].vendor);
+            for (size_t i = 1; i < kCount; i++) {
+                uint32_t key = keys[i];
+                size_t j = i;
+                for (; j > 0 && keys[j - 1] > key; j--) keys[j] = keys[j - 1];
+                keys[j] = key;
+            }
+            return keys;
+        }();
+
+        constexpr bool Validate() {
+            for (size_t i = 0; i < kCount; i++) {
+                uint32_t oui = kKeys[i] >> 8;
+                // 第一个字节最低两位：I/G（组播）与 U/L（本地管理）都必须为 0
+                if (oui > 0xFFFFFF || (oui >> 16) & 0x03) return false;
+                if (i > 0 && (kKeys[i - 1] >> 8) == oui) return false;
+            }
+            return true;
+        }
+        static_assert(Validate(), "OUI 表含重复项、组播或本地管理前缀");
+
+        // 按厂商分组的下标（指向 kKeys）及各组起始位置
+        inline constexpr auto kVendorStart = [] {
+            std::array<uint16_t, kVendorCount + 1> start{};
+            for (size_t i = 0; i < kCount; i++) start[(kKeys[i] & 0xff) + 1]++;
+            for (size_t v = 0; v < kVendorCount; v++) start[v + 1] += start[v];
+            return start;
+        }();
+
+        inline constexpr auto kVendorIndex = [] {
+            std::array<uint16_t, kCount> index{};
+            auto next = kVendorStart;
+            for (size_t i = 0; i < kCount; i++) index[next[kKeys[i] & 0xff]++] = uint16_t(i);
+            return index;
+        }();
+
+        constexpr bool EveryVendorPresent() {
+            for (size_t v = 0; v < kVendorCount; v++) {
+                if (kVendorStart[v] == kVendorStart[v + 1]) return false;
+            }
+            return true;
+        }
+        static_assert(EveryVendorPresent(), "每个厂商至少需要一个 OUI");
+
+        // 厂商权重的 Vose 别名表：一次等概率选列 + 一次比较即可按权重抽样
+        struct Alias {
+            std::array<uint32_t, kVendorCount> threshold;  // 32 位定点概率
+            std::array<uint8_t, kVendorCount> alias;
+        };
+
+        inline constexpr Alias kVendorAlias = [] {
+            Alias table{};
+            uint64_t total = 0;
+            for (uint32_t w : kVendorWeights) total += w;
+            // 按 n * w / total 缩放到以 2^32 为 1 的定点数
+            std::array<uint64_t, kVendorCount> scaled{};
+            for (size_t i = 0; i < kVendorCount; i++) {
+                scaled[i] = (uint64_t(kVendorWeights[i]) * kVendorCount << 32) / total;
+            }
+            std::array<uint8_t, kVendorCount> small{}, large{};
+            size_t ns = 0, nl = 0;
+            for (size_t i = 0; i < kVendorCount; i++) {
+                if (scaled[i] < (uint64_t(1) << 32)) small[ns++] = uint8_t(i);
+                else large[nl++] = uint8_t(i);
+            }
+            while (ns > 0 && nl > 0) {
+                uint8_t s = small[--ns];
+                uint8_t l = large[--nl];
+                table.threshold[s] = uint32_t(scaled[s]);
+                table.alias[s] = l;
+                scaled[l] -= (uint64_t(1) << 32) - scaled[s];
+                if (scaled[l] < (uint64_t(1) << 32)) small[ns++] = l;
+                else large[nl++] = l;
+            }
+            // 剩余列概率为 1（定点误差）
+            while (nl > 0) {
+                uint8_t l = large[--nl];
+                table.threshold[l] = UINT32_MAX;
+                table.alias[l] = l;
+            }
+            while (ns > 0) {
+                uint8_t s = small[--ns];
+                table.threshold[s] = UINT32_MAX;
+                table.alias[s] = s;
+            }
+            return table;
+        }();
+    }
+
+    inline constexpr size_t kEntryCount = detail::kCount;
+
+    // 查找 OUI 对应的厂商，不在表中返回 Vendor::kCount。
+    // 定长步数的无分支二分（循环次数只取决于表长）。
+    inline Vendor Lookup(uint32_t oui) {
+        const uint32_t *base = detail::kKeys.data();
+        size_t n = detail::kCount;
+        uint32_t key = oui << 8;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = (base[half] < key) ? base + half : base;
+            n -= half;
+        }
+        if (*base < key) base++;
+        if (base == detail::kKeys.data() + detail::kCount || (*base >> 8) != oui) return Vendor::kCount;
+        return Vendor(*base & 0xff);
+    }
+
+    // 按厂商权重抽取厂商
+    template <typename Rng>
+    inline Vendor PickVendor(Rng &rng) {
+        uint64_t x = rng();
+        uint32_t column = uint32_t((uint64_t(uint32_t(x)) * kVendorCount) >> 32);
+        bool keep = uint32_t(x >> 32) < detail::kVendorAlias.threshold[column];
+        return Vendor(keep ? column : detail::kVendorAlias.alias[column]);
+    }
+
+    // 在指定厂商的 OUI 中等概率抽取一个
+    template <typename Rng>
+    inline uint32_t PickOui(Vendor vendor, Rng &rng) {
+        uint32_t begin = detail::kVendorStart[size_t(vendor)];
+        uint32_t count = detail::kVendorStart[size_t(vendor) + 1] - begin;
+        return detail::kKeys[detail::kVendorIndex[begin + IdFormat::detail::Bounded(count, rng)]] >> 8;
+    }
+
+    // 生成一个真实厂商前缀的单播、全局唯一 MAC：xx:xx:xx:xx:xx:xx
+    template <typename Rng>
+    inline void VendorMac(std::span<char, 18> out, Rng &rng, bool upper = false) {
+        uint32_t oui = PickOui(PickVendor(rng), rng);
+        uint64_t addr = uint64_t(oui) << 24 | (rng() & 0xFFFFFF);
+        const char *digits = upper ? IdFormat::detail::kHexUpper : IdFormat::detail::kHexLower;
+        for (int i = 0; i < 6; i++) {
+            auto byte = uint8_t(addr >> (40 - 8 * i));
+            out[i * 3] = digits[byte >> 4];
+            out[i * 3 + 1] = digits[byte & 0xf];
+            out[i * 3 + 2] = ':';
+        }
+        out[17] = '\0';
+    }
+}
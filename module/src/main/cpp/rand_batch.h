@@ -0,0 +1,245 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include "zygisk_device_random.h"
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RANDUTIL_BATCH_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RANDUTIL_BATCH_SSE2 1
+#endif
+
+// 批量生成：一次性为预生成池填充大量标识。
+// 64 位随机数按 16 位拆分后用“乘 10 取高位”得到数字，乘积低 16 位 < 6 时拒绝重抽（Lemire 拒绝法，无偏），
+// 十六进制按 4 位拆分查表；Luhn 校验位对 16 条记录并行累加。
+// aarch64 用 NEON，x86 用 SSE2，其他平台（含 armeabi-v7a）走标量实现，结果分布相同。
+namespace RandUtil {
+    enum class Format : uint8_t {
+        Imei,        // 15 位，Luhn 校验
+        SimSerial,   // 20 位数字
+        AndroidId,   // 16 位十六进制
+        MediaDrmId,  // 32 位十六进制
+        Mac,         // xx:xx:xx:xx:xx:xx
+    };
+
+    constexpr size_t FormatLength(Format format) {
+        switch (format) {
+            case Format::Imei: return kImeiLen;
+            case Format::SimSerial: return kSimSerialLen;
+            case Format::AndroidId: return kHexIdLen;
+            case Format::MediaDrmId: return kMediaDrmIdLen;
+            case Format::Mac: return kMacLen;
+        }
+        return 0;
+    }
+
+    // 每条记录在 arena 中占用的字节数（含结尾 '\0'）
+    constexpr size_t RecordStride(Format format) { return FormatLength(format) + 1; }
+
+    namespace batch {
+        // v * 10 的低 16 位 < 65536 % 10 时拒绝，其余 v 中每个数字 (v * 10) >> 16 恰好对应 6553 个取值
+        inline constexpr uint16_t kDigitReject = 65536 % 10;
+
+        inline constexpr bool Rejected(uint16_t v) { return uint16_t(v * 10u) < kDigitReject; }
+
+        static_assert([] {
+            uint32_t hits[10] = {};
+            for (uint32_t v = 0; v < 65536; v++) {
+                if (!Rejected(uint16_t(v))) hits[(v * 10) >> 16]++;
+            }
+            for (uint32_t h : hits) {
+                if (h != 65536 / 10) return false;
+            }
+            return true;
+        }(), "数字拒绝采样必须无偏");
+
+        // Luhn 累加和（<= 16 * 9）到校验位的映射表
+        inline constexpr auto kLuhnCheck = [] {
+            std::array<uint8_t, 256> table{};
+            for (size_t i = 0; i < table.size(); i++) table[i] = uint8_t((10 - i % 10) % 10);
+            return table;
+        }();
+
+        template <typename Rng>
+        inline uint8_t RedrawDigit(Rng &rng) {
+            uint16_t v;
+            do { v = uint16_t(rng()); } while (Rejected(v));
+            return uint8_t((uint32_t(v) * 10) >> 16);
+        }
+
+        // 两个 64 位随机数 -> 8 个数字（值为 base + 0..9）
+        template <typename Rng>
+        inline void Digits8(uint8_t *out, uint8_t base, Rng &rng) {
+            uint64_t words[2] = {rng(), rng()};
+#if defined(RANDUTIL_BATCH_NEON)
+            uint16x8_t x = vreinterpretq_u16_u64(vld1q_u64(words));
+            uint16x4_t lo = vshrn_n_u32(vmull_n_u16(vget_low_u16(x), 10), 16);
+            uint16x4_t hi = vshrn_n_u32(vmull_n_u16(vget_high_u16(x), 10), 16);
+            uint8x8_t d = vadd_u8(vmovn_u16(vcombine_u16(lo, hi)), vdup_n_u8(base));
+            vst1_u8(out, d);
+            bool rejected = vmaxvq_u16(vcltq_u16(vmulq_n_u16(x, 10), vdupq_n_u16(kDigitReject))) != 0;
+#elif defined(RANDUTIL_BATCH_SSE2)
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words));
+            __m128i d = _mm_mulhi_epu16(x, _mm_set1_epi16(10));
+            d = _mm_add_epi16(d, _mm_set1_epi16(base));
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(d, d));
+            // 低 16 位 <= kDigitReject - 1 时饱和减法得 0
+            __m128i low = _mm_subs_epu16(_mm_mullo_epi16(x, _mm_set1_epi16(10)), _mm_set1_epi16(kDigitReject - 1));
+            bool rejected = _mm_movemask_epi8(_mm_cmpeq_epi16(low, _mm_setzero_si128())) != 0;
+#else
+            bool rejected = false;
+            for (int i = 0; i < 8; i++) {
+                auto v = uint16_t(words[i / 4] >> (16 * (i % 4)));
+                out[i] = uint8_t(base + ((uint32_t(v) * 10) >> 16));
+                rejected |= Rejected(v);
+            }
+#endif
+            if (__builtin_expect(rejected, 0)) {
+                for (int i = 0; i < 8; i++) {
+                    auto v = uint16_t(words[i / 4] >> (16 * (i % 4)));
+                    if (Rejected(v)) out[i] = uint8_t(base + RedrawDigit(rng));
+                }
+            }
+        }
+
+        // n 个数字，按 8 个一组展开
+        template <typename Rng>
+        inline void Digits(uint8_t *out, size_t n, uint8_t base, Rng &rng) {
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) Digits8(out + i, base, rng);
+            if (i < n) {
+                uint8_t tail[8];
+                Digits8(tail, base, rng);
+                memcpy(out + i, tail, n - i);
+            }
+        }
+
+        // 一个 64 位随机数 -> 16 个十六进制字符
+        inline void Hex16(char *out, uint64_t word) {
+#if defined(RANDUTIL_BATCH_NEON)
+            uint8x8_t bytes = vcreate_u8(word);
+            uint8x16_t nibbles = vcombine_u8(vand_u8(bytes, vdup_n_u8(0x0f)), vshr_n_u8(bytes, 4));
+            uint8x16_t table = vld1q_u8(reinterpret_cast<const uint8_t *>(detail::kHexDigits));
+            vst1q_u8(reinterpret_cast<uint8_t *>(out), vqtbl1q_u8(table, nibbles));
+#elif defined(RANDUTIL_BATCH_SSE2)
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&word));
+            __m128i mask = _mm_set1_epi8(0x0f);
+            __m128i nibbles = _mm_unpacklo_epi64(_mm_and_si128(bytes, mask),
+                                                 _mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+            // '0'..'9' 直接加偏移，10..15 额外加 ('a' - '0' - 10)
+            __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8(39));
+            __m128i ascii = _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out), ascii);
+#else
+            for (int i = 0; i < 16; i++) {
+                out[i] = detail::kHexDigits[word & 0xf];
+                word >>= 4;
+            }
+#endif
+        }
+
+        template <typename Rng>
+        inline void Hex(char *out, size_t n, Rng &rng) {
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) Hex16(out + i, rng());
+            if (i < n) {
+                char tail[16];
+                Hex16(tail, rng());
+                memcpy(out + i, tail, n - i);
+            }
+        }
+
+        // acc[r] += row[r]（doubled 时按 Luhn 规则加倍：2d 或 2d - 9），16 条记录同时累加
+        inline void LuhnAccumulate16(uint8_t *acc, const uint8_t *row, bool doubled) {
+#if defined(RANDUTIL_BATCH_NEON)
+            uint8x16_t d = vld1q_u8(row);
+            if (doubled) {
+                uint8x16_t over = vandq_u8(vcgtq_u8(d, vdupq_n_u8(4)), vdupq_n_u8(9));
+                d = vsubq_u8(vaddq_u8(d, d), over);
+            }
+            vst1q_u8(acc, vaddq_u8(vld1q_u8(acc), d));
+#elif defined(RANDUTIL_BATCH_SSE2)
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row));
+            if (doubled) {
+                __m128i over = _mm_and_si128(_mm_cmpgt_epi8(d, _mm_set1_epi8(4)), _mm_set1_epi8(9));
+                d = _mm_sub_epi8(_mm_add_epi8(d, d), over);
+            }
+            __m128i sum = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(acc)), d);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(acc), sum);
+#else
+            for (int r = 0; r < 16; r++) {
+                uint8_t d = row[r];
+                if (doubled) d = uint8_t(d * 2 - (d > 4 ? 9 : 0));
+                acc[r] = uint8_t(acc[r] + d);
+            }
+#endif
+        }
+
+        // 16 条带 Luhn 校验位的数字串：先按“位序 x 记录”的转置布局生成，
+        // 这样每一位数字正好是一个 16 字节向量，校验和对整批并行计算。
+        template <size_t kPayload, typename Rng>
+        inline void LuhnBlock16(char *out, size_t stride, size_t records, Rng &rng) {
+            uint8_t rows[kPayload][16];
+            uint8_t acc[16] = {};
+            Digits(&rows[0][0], kPayload * 16, 0, rng);
+            for (size_t i = 0; i < kPayload; i++) LuhnAccumulate16(acc, rows[i], (kPayload - 1 - i) % 2 == 0);
+            for (size_t r = 0; r < records; r++) {
+                char *rec = out + r * stride;
+                for (size_t i = 0; i < kPayload; i++) rec[i] = char('0' + rows[i][r]);
+                rec[kPayload] = char('0' + kLuhnCheck[acc[r]]);
+                rec[kPayload + 1] = '\0';
+            }
+        }
+    }
+
+    // 生成 count 条 format 格式的标识到 arena，每条占 RecordStride(format) 字节并以 '\0' 结尾。
+    // arena 容量不足时只写满能容纳的条数，返回实际写入条数。
+    template <typename Rng>
+    inline size_t GenerateBatch(Format format, size_t count, std::span<char> arena, Rng &rng) {
+        detail::CheckEngine<Rng>();
+        const size_t stride = RecordStride(format);
+        if (count > arena.size() / stride) count = arena.size() / stride;
+        char *out = arena.data();
+
+        switch (format) {
+            case Format::Imei:
+                for (size_t done = 0; done < count; done += 16) {
+                    size_t n = count - done < 16 ? count - done : 16;
+                    batch::LuhnBlock16<kImeiLen - 1>(out + done * stride, stride, n, rng);
+                }
+                break;
+            case Format::SimSerial:
+                for (size_t i = 0; i < count; i++) {
+                    char *rec = out + i * stride;
+                    batch::Digits(reinterpret_cast<uint8_t *>(rec), kSimSerialLen, '0', rng);
+                    rec[kSimSerialLen] = '\0';
+                }
+                break;
+            case Format::AndroidId:
+            case Format::MediaDrmId: {
+                const size_t len = FormatLength(format);
+                for (size_t i = 0; i < count; i++) {
+                    char *rec = out + i * stride;
+                    batch::Hex(rec, len, rng);
+                    rec[len] = '\0';
+                }
+                break;
+            }
+            case Format::Mac:
+                // 厂商前缀需要查表，逐条生成
+                for (size_t i = 0; i < count; i++) {
+                    Oui::VendorMac(std::span<char, kMacLen + 1>(out + i * stride, kMacLen + 1), rng);
+                }
+                break;
+        }
+        return count;
+    }
+
+    inline size_t GenerateBatch(Format format, size_t count, std::span<char> arena) {
+        return GenerateBatch(format, count, arena, Engine());
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+// xoshiro256**（Blackman & Vigna）：32 字节状态，周期 2^256-1，
+// jump()/long_jump() 可把序列切成互不重叠的子序列，供每个线程独占一段。
+class Xoshiro256ss {
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    explicit Xoshiro256ss(uint64_t seed = 0) { Seed(seed); }
+
+    // 用 splitmix64 把 64 位种子扩展成 256 位状态（保证不全为 0）
+    void Seed(uint64_t seed) {
+        for (uint64_t &word : s) {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    result_type operator()() {
+        const uint64_t result = Rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = Rotl(s[3], 45);
+        return result;
+    }
+
+    // 前进 2^128 步
+    void jump() {
+        static constexpr uint64_t kJump[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                             0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+        Advance(kJump);
+    }
+
+    // 前进 2^192 步
+    void long_jump() {
+        static constexpr uint64_t kLongJump[] = {0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+                                                 0x77710069854ee241ULL, 0x39109bb02acbe635ULL};
+        Advance(kLongJump);
+    }
+
+private:
+    uint64_t s[4];
+
+    static constexpr uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    void Advance(const uint64_t (&poly)[4]) {
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (uint64_t word : poly) {
+            for (int b = 0; b < 64; b++) {
+                if (word & (1ULL << b)) {
+                    t[0] ^= s[0];
+                    t[1] ^= s[1];
+                    t[2] ^= s[2];
+                    t[3] ^= s[3];
+                }
+                (*this)();
+            }
+        }
+        s[0] = t[0];
+        s[1] = t[1];
+        s[2] = t[2];
+        s[3] = t[3];
+    }
+};
+
+namespace RandEngine {
+    namespace detail {
+        // 主序列：每个新线程从这里领取一段（领取后主序列 jump 2^128 步）。
+        // 只在线程首次取随机数时加锁一次，之后各线程无锁、无共享缓存行。
+        struct Master {
+            std::mutex lock;
+            Xoshiro256ss next{std::random_device{}() ^ (uint64_t(std::random_device{}()) << 32)};
+        };
+
+        inline Master &GetMaster() {
+            static Master master;
+            return master;
+        }
+
+        inline Xoshiro256ss NextStream() {
+            Master &master = GetMaster();
+            std::lock_guard<std::mutex> guard(master.lock);
+            Xoshiro256ss stream = master.next;
+            master.next.jump();
+            return stream;
+        }
+    }
+
+    // 重新设置主种子：之后新建的线程流全部由该种子确定性派生，
+    // 已经领取过随机流的线程不受影响。
+    inline void SetMasterSeed(uint64_t seed) {
+        detail::Master &master = detail::GetMaster();
+        std::lock_guard<std::mutex> guard(master.lock);
+        master.next.Seed(seed);
+    }
+
+    // 当前线程独占的随机引擎
+    inline Xoshiro256ss &ThreadLocal() {
+        static thread_local Xoshiro256ss engine = detail::NextStream();
+        return engine;
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+// Settings.Secure 键分派：绝大多数读取的键与我们无关，必须尽快放行。
+//   1. GetStringLength 查长度位图，长度不符的键直接放行（不复制任何字符）
+//   2. 长度命中时 GetStringRegion 复制到栈缓冲区
+//   3. 编译期求出的完美哈希定位唯一候选，再逐字比较 UTF-16
+namespace SettingsKeys {
+    enum class Key : uint8_t {
+        None = 0,
+        AndroidId,
+        BluetoothAddress,
+        BluetoothName,
+    };
+
+    namespace detail {
+        struct Entry {
+            const char *name;
+            size_t len;
+            Key key;
+        };
+
+        inline constexpr size_t Length(const char *s) {
+            size_t n = 0;
+            while (s[n] != '\0') n++;
+            return n;
+        }
+
+        inline constexpr Entry Make(const char *name, Key key) { return {name, Length(name), key}; }
+
+        // 所有被拦截的键
+        inline constexpr Entry kEntries[] = {
+                Make("android_id", Key::AndroidId),
+                Make("bluetooth_address", Key::BluetoothAddress),
+                Make("bluetooth_name", Key::BluetoothName),
+        };
+
+        inline constexpr size_t kMaxLen = [] {
+            size_t max = 0;
+            for (const Entry &e : kEntries) max = e.len > max ? e.len : max;
+            return max;
+        }();
+        static_assert(kMaxLen < 64, "length bitmap holds lengths below 64");
+
+        inline constexpr uint64_t kLengthMask = [] {
+            uint64_t mask = 0;
+            for (const Entry &e : kEntries) mask |= uint64_t(1) << e.len;
+            return mask;
+        }();
+
+        // 哈希取长度、首字符、中间字符和末字符，乘以种子后取高位
+        inline constexpr uint32_t kBits = 3;
+        inline constexpr size_t kSlots = size_t(1) << kBits;
+        static_assert(std::size(kEntries) <= kSlots);
+
+        template <typename Char>
+        inline constexpr uint32_t Hash(const Char *s, size_t len, uint32_t seed) {
+            uint32_t h = uint32_t(len) ^ uint32_t(uint16_t(s[0])) << 6 ^
+                         uint32_t(uint16_t(s[len / 2])) << 13 ^ uint32_t(uint16_t(s[len - 1])) << 20;
+            return (h * seed) >> (32 - kBits);
+        }
+
+        // 从小到大搜索第一个让所有键落入不同槽位的奇数种子
+        inline constexpr uint32_t kSeed = [] {
+            for (uint32_t seed = 0x9e3779b1u;; seed += 2) {
+                bool used[kSlots] = {};
+                bool ok = true;
+                for (const Entry &e : kEntries) {
+                    uint32_t slot = Hash(e.name, e.len, seed);
+                    if (used[slot]) {
+                        ok = false;
+                        break;
+                    }
+                    used[slot] = true;
+                }
+                if (ok) return seed;
+            }
+        }();
+
+        // 槽位 -> kEntries 下标 + 1，0 表示空槽
+        inline constexpr auto kTable = [] {
+            struct { uint8_t index[kSlots]; } table = {};
+            for (size_t i = 0; i < std::size(kEntries); i++) {
+                table.index[Hash(kEntries[i].name, kEntries[i].len, kSeed)] = uint8_t(i + 1);
+            }
+            return table;
+        }();
+    }
+
+    // 在已复制出的 UTF-16 键上查表
+    inline Key Lookup(const jchar *chars, size_t len) {
+        if (len >= 64 || (detail::kLengthMask >> len & 1) == 0) return Key::None;
+        uint8_t index = detail::kTable.index[detail::Hash(chars, len, detail::kSeed)];
+        if (index == 0) return Key::None;
+        const detail::Entry &e = detail::kEntries[index - 1];
+        if (e.len != len) return Key::None;
+        for (size_t i = 0; i < len; i++) {
+            if (chars[i] != jchar(e.name[i])) return Key::None;
+        }
+        return e.key;
+    }
+
+    // 直接在 jstring 上分派；未命中路径只有一次 GetStringLength
+    inline Key Resolve(JNIEnv *env, jstring key) {
+        if (key == nullptr) return Key::None;
+        jsize len = env->GetStringLength(key);
+        if (len <= 0 || size_t(len) > detail::kMaxLen || (detail::kLengthMask >> len & 1) == 0) return Key::None;
+        jchar buf[detail::kMaxLen];
+        env->GetStringRegion(key, 0, len, buf);
+        return Lookup(buf, size_t(len));
+    }
+}
@@ -0,0 +1,161 @@
+#include "symbol_cache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "log.h"
+
+namespace SymbolCache {
+    namespace {
+        constexpr const char *kDir = "cache";
+        constexpr const char *kPath = "cache/symbols.bin";
+        constexpr size_t kMaxPending = 64;
+        constexpr size_t kMaxEntries = 1 << 16;
+
+        // 只在 preAppSpecialize（单线程）中使用
+        int s_dir = -1;
+        const Entry *s_entries = nullptr;
+        size_t s_count = 0;
+        void *s_map = nullptr;
+        size_t s_mapSize = 0;
+        Entry s_pending[kMaxPending];
+        size_t s_pendingCount = 0;
+
+        bool Less(const Entry &a, const Entry &b) {
+            return a.build_id != b.build_id ? a.build_id < b.build_id : a.symbol < b.symbol;
+        }
+
+        bool SameKey(const Entry &a, const Entry &b) {
+            return a.build_id == b.build_id && a.symbol == b.symbol;
+        }
+
+        void Unmap() {
+            if (s_map != nullptr) munmap(s_map, s_mapSize);
+            s_map = nullptr;
+            s_mapSize = 0;
+            s_entries = nullptr;
+            s_count = 0;
+        }
+    }
+
+    uint64_t BuildId(const ElfW(Phdr) *phdr, size_t phnum, ElfW(Addr) bias) {
+        for (size_t i = 0; i < phnum; i++) {
+            if (phdr[i].p_type != PT_NOTE) continue;
+            auto *p = reinterpret_cast<const uint8_t *>(bias + phdr[i].p_vaddr);
+            const uint8_t *end = p + phdr[i].p_memsz;
+            while (p + sizeof(ElfW(Nhdr)) <= end) {
+                auto *note = reinterpret_cast<const ElfW(Nhdr) *>(p);
+                const uint8_t *name = p + sizeof(ElfW(Nhdr));
+                const uint8_t *desc = name + ((note->n_namesz + 3) & ~3u);
+                const uint8_t *next = desc + ((note->n_descsz + 3) & ~3u);
+                if (next > end) break;
+                if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 && memcmp(name, "GNU", 4) == 0 &&
+                    note->n_descsz > 0) {
+                    return Hash64(desc, note->n_descsz);
+                }
+                p = next;
+            }
+        }
+        return 0;
+    }
+
+    bool Open(int moduleDir) {
+        Unmap();
+        s_pendingCount = 0;
+        s_dir = moduleDir;
+        if (moduleDir < 0) return false;
+        int fd = openat(moduleDir, kPath, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        void *map = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(Header)) {
+            map = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (map == MAP_FAILED) return false;
+
+        // 格式或大小不符时当作没有缓存，下一次 Flush 会整体重写
+        auto *header = static_cast<const Header *>(map);
+        if (header->magic != kMagic || header->version != kVersion || header->entry_size != sizeof(Entry) ||
+            header->count > kMaxEntries || sizeof(Header) + size_t(header->count) * sizeof(Entry) > size_t(st.st_size)) {
+            LOGW("Ignore invalid symbol cache %s", kPath);
+            munmap(map, size_t(st.st_size));
+            return false;
+        }
+        s_map = map;
+        s_mapSize = size_t(st.st_size);
+        s_entries = reinterpret_cast<const Entry *>(header + 1);
+        s_count = header->count;
+        LOGD("Symbol cache mapped (%zu entries)", s_count);
+        return true;
+    }
+
+    const Entry *Find(uint64_t buildId, uint64_t symbol) {
+        Entry key = {buildId, symbol, 0, 0, 0};
+        const Entry *end = s_entries + s_count;
+        const Entry *it = std::lower_bound(s_entries, end, key, Less);
+        if (it != end && SameKey(*it, key)) return it;
+        return nullptr;
+    }
+
+    void Add(const Entry &entry) {
+        if (s_pendingCount < kMaxPending) s_pending[s_pendingCount++] = entry;
+    }
+
+    bool Flush() {
+        if (s_pendingCount == 0 || s_dir < 0) return false;
+
+        // 同一个库（路径相同）换了 build-id 说明已 OTA，丢弃它的旧条目；相同键以新条目为准
+        std::vector<Entry> merged;
+        merged.reserve(s_count + s_pendingCount);
+        for (size_t i = 0; i < s_count; i++) {
+            const Entry &old = s_entries[i];
+            bool stale = false;
+            for (size_t p = 0; p < s_pendingCount && !stale; p++) {
+                stale = SameKey(old, s_pending[p]) ||
+                        (old.path == s_pending[p].path && old.build_id != s_pending[p].build_id);
+            }
+            if (!stale) merged.push_back(old);
+        }
+        merged.insert(merged.end(), s_pending, s_pending + s_pendingCount);
+        std::sort(merged.begin(), merged.end(), Less);
+        merged.erase(std::unique(merged.begin(), merged.end(), SameKey), merged.end());
+        if (merged.size() > kMaxEntries) merged.resize(kMaxEntries);
+
+        mkdirat(s_dir, kDir, 0700);
+        char tmp[64];
+        snprintf(tmp, sizeof(tmp), "%s.%d", kPath, getpid());
+        int fd = openat(s_dir, tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            LOGW("Cannot create symbol cache %s", tmp);
+            return false;
+        }
+        Header header = {kMagic, kVersion, uint32_t(merged.size()), uint32_t(sizeof(Entry))};
+        size_t bytes = merged.size() * sizeof(Entry);
+        bool ok = write(fd, &header, sizeof(header)) == ssize_t(sizeof(header)) &&
+                  write(fd, merged.data(), bytes) == ssize_t(bytes);
+        close(fd);
+        // 多个应用同时写回时后 rename 的一方胜出，丢失的条目下次启动再补上
+        if (!ok || renameat(s_dir, tmp, s_dir, kPath) != 0) {
+            LOGW("Cannot write symbol cache %s", kPath);
+            unlinkat(s_dir, tmp, 0);
+            return false;
+        }
+        LOGI("Symbol cache updated: %zu new, %zu total", s_pendingCount, merged.size());
+        s_pendingCount = 0;
+        return true;
+    }
+
+    int OpenDir() {
+        if (s_dir < 0) return -1;
+        mkdirat(s_dir, kDir, 0700);
+        int fd = openat(s_dir, kDir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) LOGW("Cannot open symbol cache directory %s", kDir);
+        return fd;
+    }
+}
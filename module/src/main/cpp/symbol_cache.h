@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <link.h>
+
+// Hook 目标解析结果的持久缓存：模块目录 cache/symbols.bin，所有目标应用共用。
+// 键是 (库的 GNU build-id, 符号名) 的哈希，值是 GOT 槽相对加载基址的偏移以及解析标志。
+// 文件按键排序，直接 mmap 后二分查找；build-id 只需读内存中的 PT_NOTE，命中时不再解析任何 ELF 结构。
+// OTA 后库的 build-id 改变，旧条目自然不再命中，并在下一次写回时按库路径清理掉。
+namespace SymbolCache {
+    constexpr uint32_t kMagic = 0x4d595352;  // "RSYM"
+    constexpr uint32_t kVersion = 4;
+
+    // 解析标志
+    namespace Flags {
+        inline constexpr uint32_t Imported = 1u << 0;  // 库的重定位表引用了该符号
+        inline constexpr uint32_t Packed = 1u << 1;    // 库含有无法扫描的压缩重定位
+        inline constexpr uint32_t Defined = 1u << 2;   // 库中定义了该符号（只对未导入的目标检查）
+        inline constexpr uint32_t Got = 1u << 3;       // 只有一条 JUMP_SLOT 引用该符号，got 有效，可以直接改写
+        inline constexpr uint32_t Relro = 1u << 4;     // GOT 槽位于 PT_GNU_RELRO，改写前需临时设为可写
+    }
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t count;
+        uint32_t entry_size;
+    };
+
+    struct Entry {
+        uint64_t build_id;  // build-id 字节的 FNV-1a
+        uint64_t symbol;    // 符号名的 FNV-1a
+        uint64_t got;       // GOT 槽地址 - 加载基址
+        uint32_t path;      // 库路径的 FNV-1a，OTA 后用来清理同一个库的旧条目
+        uint32_t flags;
+    };
+    static_assert(sizeof(Entry) == 32);
+
+    inline constexpr uint64_t Hash64(const void *data, size_t len) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < len; i++) {
+            h ^= static_cast<const uint8_t *>(data)[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    inline constexpr uint64_t Hash64(const char *s) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (; *s != '\0'; s++) {
+            h ^= uint8_t(*s);
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    // 读已加载库的 NT_GNU_BUILD_ID，返回其哈希；没有 build-id 时返回 0（这样的库不缓存）
+    uint64_t BuildId(const ElfW(Phdr) *phdr, size_t phnum, ElfW(Addr) bias);
+
+    // 映射已有的缓存文件（只读），并记住模块目录供 Flush 写回；只能在 preAppSpecialize 中调用
+    bool Open(int moduleDir);
+
+    const Entry *Find(uint64_t buildId, uint64_t symbol);
+
+    // 记录本次新解析的条目，Flush 时与已有文件合并
+    void Add(const Entry &entry);
+
+    // 有新条目时合并、排序并写到临时文件再 rename 替换，读者看到的始终是完整文件
+    bool Flush();
+
+    // 打开（必要时创建）模块目录下的 cache/，交给 xdl_set_cache_dir 存放 MiniDebugInfo 库的符号索引；
+    // 调用方负责 close，失败返回 -1。同样只能在 Open 之后、preAppSpecialize 之内调用
+    int OpenDir();
+}
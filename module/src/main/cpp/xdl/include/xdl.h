@@ -79,6 +79,12 @@ void xdl_addr_clean(void **cache);
 #define XDL_FULL_PATHNAME 0x01
 int xdl_iterate_phdr(int (*callback)(struct dl_phdr_info *, size_t, void *), void *data, int flags);
 
+//
+// Directory for caching .symtab decompressed from .gnu_debugdata (MiniDebugInfo), keyed by build-id.
+// The fd is not owned by xDL, pass -1 (the default) to stop using it before closing it.
+//
+void xdl_set_cache_dir(int dir_fd);
+
 //
 // Custom dlinfo().
 //
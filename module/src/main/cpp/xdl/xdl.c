@@ -41,6 +41,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "xdl_cache.h"
 #include "xdl_iterate.h"
 #include "xdl_linker.h"
 #include "xdl_lzma.h"
@@ -56,11 +57,51 @@
 #define XDL_SYMTAB_IS_EXPORT_SYM(shndx) \
   (SHN_UNDEF != (shndx) && !((shndx) >= SHN_LORESERVE && (shndx) <= SHN_HIRESERVE))
 
+// bionic keeps d_ptr in .dynamic as an unrelocated vaddr; glibc rewrites it in place (host benchmarks)
+#ifdef __BIONIC__
+#define XDL_DYN_PTR(load_bias, ptr) ((load_bias) + (ptr))
+#else
+#define XDL_DYN_PTR(load_bias, ptr) ((ptr) >= (load_bias) ? (ptr) : (load_bias) + (ptr))
+#endif
+
+// host benchmarks only: a non-zero xdl_symtab_force_heap skips xdl_symtab_map(), so the heap copies of
+// .symtab & .strtab can be measured against the mapping in the same process
+#ifdef XDL_HOST_BENCH
+int xdl_symtab_force_heap = 0;
+#define XDL_SYMTAB_MAP_ENABLED (0 == xdl_symtab_force_heap)
+#else
+#define XDL_SYMTAB_MAP_ENABLED 1
+#endif
+
 extern __attribute((weak)) unsigned long int getauxval(unsigned long int);
 
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wpadded"
 
+// one symbol interval in the address index: [start, start + size) relative to load_bias
+typedef struct {
+  uintptr_t start;
+  uint32_t size;
+  uint32_t sym_idx : 31;  // index into .dynsym or .symtab
+  uint32_t nested : 1;    // an earlier entry covers this start, keep walking back on lookup
+} xdl_addr_entry_t;
+
+// open-addressing hash index over .symtab names, built on the first xdl_dsym() lookup
+typedef struct {
+  bool try_build;
+  uint32_t shift;  // 32 - log2(slots count), slots count is a power of 2
+  uint32_t *idx;   // .symtab index + 1 of each slot, 0 for an empty slot
+  uint8_t *tags;   // low 8 bits of the GNU hash, compared before strcmp
+} xdl_name_index_t;
+
+// address-sorted symbol intervals, built on the first xdl_addr() lookup
+typedef struct {
+  bool try_build;
+  xdl_addr_entry_t *entries;
+  size_t entries_cnt;
+  size_t last_hit;  // entry matched by the previous lookup
+} xdl_addr_index_t;
+
 typedef struct xdl {
   char *pathname;
   uintptr_t load_bias;
@@ -108,6 +149,17 @@ typedef struct xdl {
   size_t symtab_cnt;
   char *strtab;  // .strtab
   size_t strtab_sz;
+  void *symtab_map;  // read-only file mapping that .symtab & .strtab point into, NULL for heap copies
+  size_t symtab_map_sz;
+  bool symtab_cached;  // the name index and the .symtab address index also point into symtab_map
+  xdl_name_index_t symtab_name_index;
+
+  //
+  // (3) for searching symbols by address in xdl_addr()
+  //
+
+  xdl_addr_index_t dynsym_addr_index;
+  xdl_addr_index_t symtab_addr_index;
 } xdl_t;
 
 #pragma clang diagnostic pop
@@ -127,25 +179,26 @@ static int xdl_dynsym_load(xdl_t *self) {
 
   // iterate the dynamic segment
   for (ElfW(Dyn) *entry = dynamic; entry && entry->d_tag != DT_NULL; entry++) {
+    uintptr_t ptr = XDL_DYN_PTR(self->load_bias, entry->d_un.d_ptr);
     switch (entry->d_tag) {
       case DT_SYMTAB:  //.dynsym
-        self->dynsym = (ElfW(Sym) *)(self->load_bias + entry->d_un.d_ptr);
+        self->dynsym = (ElfW(Sym) *)ptr;
         break;
       case DT_STRTAB:  //.dynstr
-        self->dynstr = (const char *)(self->load_bias + entry->d_un.d_ptr);
+        self->dynstr = (const char *)ptr;
         break;
       case DT_HASH:  //.hash
-        self->sysv_hash.buckets_cnt = ((const uint32_t *)(self->load_bias + entry->d_un.d_ptr))[0];
-        self->sysv_hash.chains_cnt = ((const uint32_t *)(self->load_bias + entry->d_un.d_ptr))[1];
-        self->sysv_hash.buckets = &(((const uint32_t *)(self->load_bias + entry->d_un.d_ptr))[2]);
+        self->sysv_hash.buckets_cnt = ((const uint32_t *)ptr)[0];
+        self->sysv_hash.chains_cnt = ((const uint32_t *)ptr)[1];
+        self->sysv_hash.buckets = &(((const uint32_t *)ptr)[2]);
         self->sysv_hash.chains = &(self->sysv_hash.buckets[self->sysv_hash.buckets_cnt]);
         break;
       case DT_GNU_HASH:  //.gnu.hash
-        self->gnu_hash.buckets_cnt = ((const uint32_t *)(self->load_bias + entry->d_un.d_ptr))[0];
-        self->gnu_hash.symoffset = ((const uint32_t *)(self->load_bias + entry->d_un.d_ptr))[1];
-        self->gnu_hash.bloom_cnt = ((const uint32_t *)(self->load_bias + entry->d_un.d_ptr))[2];
-        self->gnu_hash.bloom_shift = ((const uint32_t *)(self->load_bias + entry->d_un.d_ptr))[3];
-        self->gnu_hash.bloom = (const ElfW(Addr) *)(self->load_bias + entry->d_un.d_ptr + 16);
+        self->gnu_hash.buckets_cnt = ((const uint32_t *)ptr)[0];
+        self->gnu_hash.symoffset = ((const uint32_t *)ptr)[1];
+        self->gnu_hash.bloom_cnt = ((const uint32_t *)ptr)[2];
+        self->gnu_hash.bloom_shift = ((const uint32_t *)ptr)[3];
+        self->gnu_hash.bloom = (const ElfW(Addr) *)(ptr + 16);
         self->gnu_hash.buckets = (const uint32_t *)(&(self->gnu_hash.bloom[self->gnu_hash.bloom_cnt]));
         self->gnu_hash.chains = (const uint32_t *)(&(self->gnu_hash.buckets[self->gnu_hash.buckets_cnt]));
         break;
@@ -220,6 +273,34 @@ static void *xdl_get_memory_by_section(void *mem, size_t mem_sz, ElfW(Shdr) *shd
   return xdl_get_memory(mem, mem_sz, (size_t)shdr->sh_offset, shdr->sh_size);
 }
 
+// map the file range covering .symtab & .strtab read-only: the pages are shared through the page cache
+// with every process reading the same library, and only the touched ones become resident
+static int xdl_symtab_map(xdl_t *self, int file_fd, size_t file_sz, ElfW(Shdr) *shdr_symtab,
+                          ElfW(Shdr) *shdr_strtab) {
+  if (0 == shdr_symtab->sh_size || 0 == shdr_strtab->sh_size) return -1;
+  if (shdr_symtab->sh_offset >= file_sz || shdr_symtab->sh_size > file_sz - shdr_symtab->sh_offset) return -1;
+  if (shdr_strtab->sh_offset >= file_sz || shdr_strtab->sh_size > file_sz - shdr_strtab->sh_offset) return -1;
+
+  size_t page_sz = (size_t)sysconf(_SC_PAGESIZE);
+  size_t begin = (size_t)(shdr_symtab->sh_offset < shdr_strtab->sh_offset ? shdr_symtab->sh_offset
+                                                                         : shdr_strtab->sh_offset);
+  size_t symtab_end = (size_t)(shdr_symtab->sh_offset + shdr_symtab->sh_size);
+  size_t strtab_end = (size_t)(shdr_strtab->sh_offset + shdr_strtab->sh_size);
+  size_t end = symtab_end > strtab_end ? symtab_end : strtab_end;
+  begin &= ~(page_sz - 1);
+
+  void *map = mmap(NULL, end - begin, PROT_READ, MAP_PRIVATE, file_fd, (off_t)begin);
+  if (MAP_FAILED == map) return -1;
+
+  self->symtab = (ElfW(Sym) *)((uintptr_t)map + (size_t)shdr_symtab->sh_offset - begin);
+  self->symtab_cnt = shdr_symtab->sh_size / shdr_symtab->sh_entsize;
+  self->strtab = (char *)((uintptr_t)map + (size_t)shdr_strtab->sh_offset - begin);
+  self->strtab_sz = shdr_strtab->sh_size;
+  self->symtab_map = map;
+  self->symtab_map_sz = end - begin;
+  return 0;
+}
+
 // load from disk and memory
 static int xdl_symtab_load_from_debugdata(xdl_t *self, int file_fd, size_t file_sz,
                                           ElfW(Shdr) *shdr_debugdata) {
@@ -286,6 +367,41 @@ end:
   return r;
 }
 
+// map the cached .symtab & .strtab and their indexes, skip the file and the decompression
+static int xdl_symtab_load_from_cache(xdl_t *self, const uint8_t *build_id, size_t build_id_len) {
+  xdl_cache_symtab_t cache;
+  if (0 != xdl_cache_load(build_id, build_id_len, sizeof(xdl_addr_entry_t), &cache, &self->symtab_map,
+                          &self->symtab_map_sz))
+    return -1;
+
+  const xdl_addr_entry_t *entries = (const xdl_addr_entry_t *)cache.addr_entries;
+  for (size_t i = 0; i < cache.addr_cnt; i++) {
+    if (entries[i].sym_idx >= cache.symtab_cnt) {
+      munmap(self->symtab_map, self->symtab_map_sz);
+      self->symtab_map = NULL;
+      self->symtab_map_sz = 0;
+      return -1;
+    }
+  }
+
+  self->symtab = cache.symtab;
+  self->symtab_cnt = cache.symtab_cnt;
+  self->strtab = cache.strtab;
+  self->strtab_sz = cache.strtab_sz;
+  self->symtab_cached = true;
+  self->symtab_name_index.try_build = true;
+  self->symtab_name_index.shift = cache.name_shift;
+  self->symtab_name_index.idx = cache.name_idx;
+  self->symtab_name_index.tags = cache.name_tags;
+  self->symtab_addr_index.try_build = true;
+  self->symtab_addr_index.entries = (xdl_addr_entry_t *)cache.addr_entries;
+  self->symtab_addr_index.entries_cnt = cache.addr_cnt;
+  return 0;
+}
+
+static void xdl_symtab_save_to_cache(xdl_t *self, const char *pathname, const uint8_t *build_id,
+                                     size_t build_id_len);
+
 // load from disk and memory
 static int xdl_symtab_load(xdl_t *self) {
   if ('[' == self->pathname[0]) return -1;
@@ -293,6 +409,7 @@ static int xdl_symtab_load(xdl_t *self) {
   int r = -1;
   ElfW(Shdr) *shdrs = NULL;
   char *shstrtab = NULL;
+  char full_pathname[1024];
 
   // get base address
   uintptr_t vaddr_min = UINTPTR_MAX;
@@ -305,13 +422,18 @@ static int xdl_symtab_load(xdl_t *self) {
   if (UINTPTR_MAX == vaddr_min) return -1;
   self->base = self->load_bias + vaddr_min;
 
+  // try the cache written by an earlier process for the same build
+  uint8_t build_id[XDL_CACHE_BUILD_ID_MAX];
+  size_t build_id_len = xdl_cache_get_build_id(self->dlpi_phdr, self->dlpi_phnum, self->load_bias, build_id);
+  if (0 == xdl_symtab_load_from_cache(self, build_id, build_id_len)) return 0;
+
   // open file
   int flags = O_RDONLY | O_CLOEXEC;
   int file_fd;
   if ('/' == self->pathname[0]) {
+    snprintf(full_pathname, sizeof(full_pathname), "%s", self->pathname);
     file_fd = open(self->pathname, flags);
   } else {
-    char full_pathname[1024];
     // try the fast method
     snprintf(full_pathname, sizeof(full_pathname), "%s/%s", XDL_LIB_PATH, self->pathname);
     file_fd = open(full_pathname, flags);
@@ -350,6 +472,13 @@ static int xdl_symtab_load(xdl_t *self) {
       ElfW(Shdr) *shdr_strtab = shdrs + shdr->sh_link;
       if (SHT_STRTAB != shdr_strtab->sh_type) continue;
 
+      // map .symtab & .strtab, use heap copies if mmap() fails
+      if (XDL_SYMTAB_MAP_ENABLED && 0 == xdl_symtab_map(self, file_fd, file_sz, shdr, shdr_strtab)) {
+        // OK
+        r = 0;
+        break;
+      }
+
       // get .symtab & .strtab
       ElfW(Sym) *symtab = (ElfW(Sym) *)xdl_read_file_to_heap_by_section(file_fd, file_sz, shdr);
       if (NULL == symtab) continue;
@@ -368,6 +497,8 @@ static int xdl_symtab_load(xdl_t *self) {
       break;
     } else if (SHT_PROGBITS == shdr->sh_type && 0 == strcmp(".gnu_debugdata", shdr_name)) {
       if (0 == xdl_symtab_load_from_debugdata(self, file_fd, file_sz, shdr)) {
+        // decompress only once per build
+        xdl_symtab_save_to_cache(self, full_pathname, build_id, build_id_len);
         // OK
         r = 0;
         break;
@@ -545,8 +676,17 @@ void *xdl_close(void *handle) {
 
   xdl_t *self = (xdl_t *)handle;
   if (NULL != self->pathname) free(self->pathname);
-  if (NULL != self->symtab) free(self->symtab);
-  if (NULL != self->strtab) free(self->strtab);
+  if (NULL != self->symtab_map) {
+    munmap(self->symtab_map, self->symtab_map_sz);
+  } else {
+    if (NULL != self->symtab) free(self->symtab);
+    if (NULL != self->strtab) free(self->strtab);
+  }
+  if (!self->symtab_cached) {
+    if (NULL != self->symtab_name_index.idx) free(self->symtab_name_index.idx);
+    if (NULL != self->symtab_addr_index.entries) free(self->symtab_addr_index.entries);
+  }
+  if (NULL != self->dynsym_addr_index.entries) free(self->dynsym_addr_index.entries);
 
   void *linker_handle = self->linker_handle;
   free(self);
@@ -651,6 +791,75 @@ void *xdl_sym(void *handle, const char *symbol, size_t *symbol_size) {
   return (void *)(self->load_bias + sym->st_value);
 }
 
+// the GNU hash of similar names differs mostly in the low bits, spread it with Fibonacci hashing
+#define XDL_NAME_INDEX_SLOT(hash, shift) (((hash) * 2654435769u) >> (shift))
+
+static void xdl_name_index_build(xdl_t *self) {
+  xdl_name_index_t *index = &self->symtab_name_index;
+
+  // names are hashed without a length limit, so .strtab must end with '\0'
+  if (0 == self->strtab_sz || '\0' != self->strtab[self->strtab_sz - 1]) return;
+  if (self->symtab_cnt >= UINT32_MAX / 2) return;
+
+  // load factor <= 0.75
+  size_t cnt = 0;
+  for (size_t i = 0; i < self->symtab_cnt; i++)
+    if (XDL_SYMTAB_IS_EXPORT_SYM(self->symtab[i].st_shndx)) cnt++;
+  if (0 == cnt) return;
+  size_t slots = 16;
+  uint32_t shift = 28;
+  while (slots * 3 < cnt * 4) {
+    slots <<= 1;
+    shift--;
+  }
+
+  // one allocation: slots * (4 + 1) bytes
+  uint32_t *idx = calloc(slots, sizeof(uint32_t) + sizeof(uint8_t));
+  if (NULL == idx) return;
+  uint8_t *tags = (uint8_t *)(idx + slots);
+  uint32_t mask = (uint32_t)(slots - 1);
+
+  for (size_t i = 0; i < self->symtab_cnt; i++) {
+    ElfW(Sym) *sym = self->symtab + i;
+    if (!XDL_SYMTAB_IS_EXPORT_SYM(sym->st_shndx)) continue;
+    // section symbols and anonymous locals all share the empty name, they would form one huge cluster
+    if (0 == sym->st_name || sym->st_name >= self->strtab_sz || '\0' == self->strtab[sym->st_name]) continue;
+
+    const char *name = self->strtab + sym->st_name;
+    uint32_t hash = xdl_gnu_hash((const uint8_t *)name);
+    uint8_t tag = (uint8_t)hash;
+    uint32_t j = XDL_NAME_INDEX_SLOT(hash, shift);
+    // keep only the first symbol of a name (static functions repeat across objects),
+    // the same result as the old linear scan
+    while (0 != idx[j]) {
+      if (tag == tags[j] && 0 == strcmp(self->strtab + self->symtab[idx[j] - 1].st_name, name)) break;
+      j = (j + 1) & mask;
+    }
+    if (0 != idx[j]) continue;
+    idx[j] = (uint32_t)i + 1;
+    tags[j] = tag;
+  }
+
+  index->shift = shift;
+  index->idx = idx;
+  index->tags = tags;
+}
+
+static ElfW(Sym) *xdl_name_index_lookup(xdl_t *self, const char *symbol) {
+  xdl_name_index_t *index = &self->symtab_name_index;
+
+  uint32_t hash = xdl_gnu_hash((const uint8_t *)symbol);
+  uint8_t tag = (uint8_t)hash;
+  uint32_t mask = UINT32_MAX >> index->shift;
+  for (uint32_t j = XDL_NAME_INDEX_SLOT(hash, index->shift); 0 != index->idx[j]; j = (j + 1) & mask) {
+    if (tag != index->tags[j]) continue;
+    ElfW(Sym) *sym = self->symtab + (index->idx[j] - 1);
+    if (0 == strcmp(self->strtab + sym->st_name, symbol)) return sym;
+  }
+
+  return NULL;
+}
+
 void *xdl_dsym(void *handle, const char *symbol, size_t *symbol_size) {
   if (NULL == handle || NULL == symbol) return NULL;
   if (NULL != symbol_size) *symbol_size = 0;
@@ -662,20 +871,35 @@ void *xdl_dsym(void *handle, const char *symbol, size_t *symbol_size) {
     self->symtab_try_load = true;
     if (0 != xdl_symtab_load(self)) return NULL;
   }
+  if (NULL == self->symtab) return NULL;
+
+  // build the name index only once
+  if (!self->symtab_name_index.try_build) {
+    self->symtab_name_index.try_build = true;
+    xdl_name_index_build(self);
+  }
 
   // find symbol
-  if (NULL == self->symtab) return NULL;
-  for (size_t i = 0; i < self->symtab_cnt; i++) {
-    ElfW(Sym) *sym = self->symtab + i;
+  ElfW(Sym) *sym = NULL;
+  if (NULL != self->symtab_name_index.idx) {
+    // use the name index, O(1)
+    sym = xdl_name_index_lookup(self, symbol);
+  } else {
+    // index not available (allocation failed or .strtab not terminated), O(n)
+    for (size_t i = 0; i < self->symtab_cnt; i++) {
+      ElfW(Sym) *cur = self->symtab + i;
 
-    if (!XDL_SYMTAB_IS_EXPORT_SYM(sym->st_shndx)) continue;
-    if (0 != strncmp(self->strtab + sym->st_name, symbol, self->strtab_sz - sym->st_name)) continue;
+      if (!XDL_SYMTAB_IS_EXPORT_SYM(cur->st_shndx)) continue;
+      if (0 != strncmp(self->strtab + cur->st_name, symbol, self->strtab_sz - cur->st_name)) continue;
 
-    if (NULL != symbol_size) *symbol_size = sym->st_size;
-    return (void *)(self->load_bias + sym->st_value);
+      sym = cur;
+      break;
+    }
   }
+  if (NULL == sym) return NULL;
 
-  return NULL;
+  if (NULL != symbol_size) *symbol_size = sym->st_size;
+  return (void *)(self->load_bias + sym->st_value);
 }
 
 static bool xdl_elf_is_match(uintptr_t load_bias, const ElfW(Phdr) *dlpi_phdr, ElfW(Half) dlpi_phnum,
@@ -729,49 +953,200 @@ static void *xdl_open_by_addr(void *addr) {
   return (void *)self;
 }
 
-static bool xdl_sym_is_match(ElfW(Sym) *sym, uintptr_t offset, bool is_symtab) {
+static bool xdl_sym_is_indexable(ElfW(Sym) *sym, bool is_symtab) {
   if (is_symtab) {
-    if (!XDL_SYMTAB_IS_EXPORT_SYM(sym->st_shndx)) false;
+    if (!XDL_SYMTAB_IS_EXPORT_SYM(sym->st_shndx)) return false;
   } else {
-    if (!XDL_DYNSYM_IS_EXPORT_SYM(sym->st_shndx)) false;
+    if (!XDL_DYNSYM_IS_EXPORT_SYM(sym->st_shndx)) return false;
   }
 
-  return ELF_ST_TYPE(sym->st_info) != STT_TLS && offset >= sym->st_value &&
-         offset < sym->st_value + sym->st_size;
+  return ELF_ST_TYPE(sym->st_info) != STT_TLS && sym->st_size > 0 && sym->st_size <= UINT32_MAX;
 }
 
-static ElfW(Sym) *xdl_sym_by_addr(void *handle, void *addr) {
-  xdl_t *self = (xdl_t *)handle;
+static int xdl_addr_index_add(xdl_addr_index_t *index, size_t *cap, ElfW(Sym) *syms, size_t i, bool is_symtab) {
+  ElfW(Sym) *sym = syms + i;
+  if (!xdl_sym_is_indexable(sym, is_symtab) || i > 0x7FFFFFFF) return 0;
 
-  // load .dynsym only once
-  if (!self->dynsym_try_load) {
-    self->dynsym_try_load = true;
-    if (0 != xdl_dynsym_load(self)) return NULL;
+  if (index->entries_cnt == *cap) {
+    size_t new_cap = (0 == *cap) ? 256 : *cap * 2;
+    xdl_addr_entry_t *entries = realloc(index->entries, new_cap * sizeof(xdl_addr_entry_t));
+    if (NULL == entries) return -1;
+    index->entries = entries;
+    *cap = new_cap;
   }
 
-  // find symbol
-  if (NULL == self->dynsym) return NULL;
-  uintptr_t offset = (uintptr_t)addr - self->load_bias;
+  xdl_addr_entry_t *entry = &index->entries[index->entries_cnt++];
+  entry->start = (uintptr_t)sym->st_value;
+  entry->size = (uint32_t)sym->st_size;
+  entry->sym_idx = (uint32_t)i;
+  entry->nested = 0;
+  return 0;
+}
+
+// equal starts: larger intervals first, then higher symbol indexes first, so the walk back from the last
+// entry with start <= offset meets the innermost interval and, among aliases, the lowest symbol index first
+static int xdl_addr_entry_cmp(const void *a, const void *b) {
+  const xdl_addr_entry_t *x = (const xdl_addr_entry_t *)a;
+  const xdl_addr_entry_t *y = (const xdl_addr_entry_t *)b;
+  if (x->start != y->start) return x->start < y->start ? -1 : 1;
+  if (x->size != y->size) return x->size > y->size ? -1 : 1;
+  if (x->sym_idx != y->sym_idx) return x->sym_idx > y->sym_idx ? -1 : 1;
+  return 0;
+}
+
+// sort the collected intervals and mark entries that start inside an earlier one
+static void xdl_addr_index_finish(xdl_addr_index_t *index) {
+  if (0 == index->entries_cnt) return;
+  qsort(index->entries, index->entries_cnt, sizeof(xdl_addr_entry_t), xdl_addr_entry_cmp);
+
+  // shrink to fit, the index lives as long as the handle
+  xdl_addr_entry_t *entries = realloc(index->entries, index->entries_cnt * sizeof(xdl_addr_entry_t));
+  if (NULL != entries) index->entries = entries;
+
+  uintptr_t max_end = 0;
+  for (size_t i = 0; i < index->entries_cnt; i++) {
+    xdl_addr_entry_t *entry = &index->entries[i];
+    entry->nested = (max_end > entry->start) ? 1 : 0;
+    uintptr_t end = entry->start + entry->size;
+    if (end > max_end) max_end = end;
+  }
+}
+
+static void xdl_addr_index_reset(xdl_addr_index_t *index) {
+  if (NULL != index->entries) free(index->entries);
+  index->entries = NULL;
+  index->entries_cnt = 0;
+}
+
+static void xdl_addr_index_build_dynsym(xdl_t *self) {
+  xdl_addr_index_t *index = &self->dynsym_addr_index;
+  size_t cap = 0;
+
+  // only symbols reachable from the hash table are exported
   if (self->gnu_hash.buckets_cnt > 0) {
     const uint32_t *chains_all = self->gnu_hash.chains - self->gnu_hash.symoffset;
     for (size_t i = 0; i < self->gnu_hash.buckets_cnt; i++) {
       uint32_t n = self->gnu_hash.buckets[i];
       if (n < self->gnu_hash.symoffset) continue;
       do {
-        ElfW(Sym) *sym = self->dynsym + n;
-        if (xdl_sym_is_match(sym, offset, false)) return sym;
+        if (0 != xdl_addr_index_add(index, &cap, self->dynsym, n, false)) goto err;
       } while ((chains_all[n++] & 1) == 0);
     }
   } else if (self->sysv_hash.chains_cnt > 0) {
-    for (size_t i = 0; i < self->sysv_hash.chains_cnt; i++) {
-      ElfW(Sym) *sym = self->dynsym + i;
-      if (xdl_sym_is_match(sym, offset, false)) return sym;
+    for (size_t i = 0; i < self->sysv_hash.chains_cnt; i++)
+      if (0 != xdl_addr_index_add(index, &cap, self->dynsym, i, false)) goto err;
+  }
+
+  xdl_addr_index_finish(index);
+  return;
+
+err:
+  xdl_addr_index_reset(index);
+}
+
+static void xdl_addr_index_build_symtab(xdl_t *self) {
+  xdl_addr_index_t *index = &self->symtab_addr_index;
+  size_t cap = 0;
+
+  for (size_t i = 0; i < self->symtab_cnt; i++)
+    if (0 != xdl_addr_index_add(index, &cap, self->symtab, i, true)) goto err;
+
+  xdl_addr_index_finish(index);
+  return;
+
+err:
+  xdl_addr_index_reset(index);
+}
+
+// compact .symtab from .gnu_debugdata, build both indexes up front and write them to the cache directory
+static void xdl_symtab_save_to_cache(xdl_t *self, const char *pathname, const uint8_t *build_id,
+                                     size_t build_id_len) {
+  if (0 == build_id_len || !xdl_cache_is_enabled()) return;
+
+  // keep the symbols xdl_dsym() and xdl_addr() can return, in their original order
+  size_t cnt = 0;
+  for (size_t i = 0; i < self->symtab_cnt; i++) {
+    ElfW(Sym) *sym = self->symtab + i;
+    if (!XDL_SYMTAB_IS_EXPORT_SYM(sym->st_shndx)) continue;
+    bool named = 0 != sym->st_name && sym->st_name < self->strtab_sz && '\0' != self->strtab[sym->st_name];
+    if (named || xdl_sym_is_indexable(sym, true)) self->symtab[cnt++] = *sym;
+  }
+  self->symtab_cnt = cnt;
+
+  self->symtab_name_index.try_build = true;
+  xdl_name_index_build(self);
+  self->symtab_addr_index.try_build = true;
+  xdl_addr_index_build_symtab(self);
+
+  xdl_cache_symtab_t cache = {.symtab = self->symtab,
+                              .symtab_cnt = self->symtab_cnt,
+                              .strtab = self->strtab,
+                              .strtab_sz = self->strtab_sz,
+                              .name_idx = self->symtab_name_index.idx,
+                              .name_tags = self->symtab_name_index.tags,
+                              .name_shift = self->symtab_name_index.shift,
+                              .addr_entries = self->symtab_addr_index.entries,
+                              .addr_cnt = self->symtab_addr_index.entries_cnt,
+                              .addr_entry_sz = sizeof(xdl_addr_entry_t)};
+  xdl_cache_save(pathname, build_id, build_id_len, &cache);
+}
+
+// binary search for the innermost interval containing offset
+static ElfW(Sym) *xdl_addr_index_lookup(xdl_addr_index_t *index, ElfW(Sym) *syms, uintptr_t offset) {
+  xdl_addr_entry_t *entries = index->entries;
+  size_t cnt = index->entries_cnt;
+  if (0 == cnt) return NULL;
+
+  // consecutive lookups usually land in the same function
+  size_t last = index->last_hit;
+  if (last < cnt && offset >= entries[last].start && offset - entries[last].start < entries[last].size &&
+      (last + 1 == cnt || entries[last + 1].start > offset))
+    return syms + entries[last].sym_idx;
+
+  // first entry with start > offset
+  size_t lo = 0, hi = cnt;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (entries[mid].start <= offset)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  // walk back while earlier intervals may still cover offset
+  for (size_t i = lo; i > 0; i--) {
+    xdl_addr_entry_t *entry = &entries[i - 1];
+    if (offset - entry->start < entry->size) {
+      index->last_hit = i - 1;
+      return syms + entry->sym_idx;
     }
+    if (!entry->nested) break;
   }
 
   return NULL;
 }
 
+static ElfW(Sym) *xdl_sym_by_addr(void *handle, void *addr) {
+  xdl_t *self = (xdl_t *)handle;
+
+  // load .dynsym only once
+  if (!self->dynsym_try_load) {
+    self->dynsym_try_load = true;
+    if (0 != xdl_dynsym_load(self)) return NULL;
+  }
+  if (NULL == self->dynsym) return NULL;
+
+  // build the address index only once
+  if (!self->dynsym_addr_index.try_build) {
+    self->dynsym_addr_index.try_build = true;
+    xdl_addr_index_build_dynsym(self);
+  }
+
+  // find symbol
+  uintptr_t offset = (uintptr_t)addr - self->load_bias;
+  return xdl_addr_index_lookup(&self->dynsym_addr_index, self->dynsym, offset);
+}
+
 static ElfW(Sym) *xdl_dsym_by_addr(void *handle, void *addr) {
   xdl_t *self = (xdl_t *)handle;
 
@@ -780,16 +1155,17 @@ static ElfW(Sym) *xdl_dsym_by_addr(void *handle, void *addr) {
     self->symtab_try_load = true;
     if (0 != xdl_symtab_load(self)) return NULL;
   }
-
-  // find symbol
   if (NULL == self->symtab) return NULL;
-  uintptr_t offset = (uintptr_t)addr - self->load_bias;
-  for (size_t i = 0; i < self->symtab_cnt; i++) {
-    ElfW(Sym) *sym = self->symtab + i;
-    if (xdl_sym_is_match(sym, offset, true)) return sym;
+
+  // build the address index only once
+  if (!self->symtab_addr_index.try_build) {
+    self->symtab_addr_index.try_build = true;
+    xdl_addr_index_build_symtab(self);
   }
 
-  return NULL;
+  // find symbol
+  uintptr_t offset = (uintptr_t)addr - self->load_bias;
+  return xdl_addr_index_lookup(&self->symtab_addr_index, self->symtab, offset);
 }
 
 int xdl_addr(void *addr, xdl_info_t *info, void **cache) {
@@ -852,6 +1228,10 @@ int xdl_iterate_phdr(int (*callback)(struct dl_phdr_info *, size_t, void *), voi
   return xdl_iterate_phdr_impl(callback, data, flags);
 }
 
+void xdl_set_cache_dir(int dir_fd) {
+  xdl_cache_set_dir(dir_fd);
+}
+
 int xdl_info(void *handle, int request, void *info) {
   if (NULL == handle || XDL_DI_DLINFO != request || NULL == info) return -1;
 
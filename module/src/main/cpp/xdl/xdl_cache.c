@@ -0,0 +1,317 @@
+// Copyright (c) 2020-2021 HexHacking Team
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include "xdl_cache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "xdl_util.h"
+
+// Symbol cache for libraries whose .symtab only exists as .gnu_debugdata (MiniDebugInfo).
+//
+// One file per library build, named after the NT_GNU_BUILD_ID note, written into the directory set by
+// xdl_set_cache_dir(). It holds the compacted .symtab & .strtab plus the name and address indexes, so later
+// processes map it instead of decompressing. The file is written to a temporary name and renamed into
+// place, readers never see a partial file. After an OTA the new build gets a new file, and the files of
+// older builds of the same pathname are removed when it is written.
+
+#define XDL_CACHE_MAGIC   0x53434458u  // "XDCS"
+#define XDL_CACHE_VERSION 2
+#define XDL_CACHE_PREFIX  "xdl-"
+#define XDL_CACHE_SUFFIX  ".sym"
+
+#define XDL_CACHE_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+// xdl_name_index_build() starts at 16 slots and doubles, 0 means the file has no name index
+#define XDL_CACHE_NAME_SHIFT_MIN 1
+#define XDL_CACHE_NAME_SHIFT_MAX 28
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t sym_sz;         // sizeof(ElfW(Sym)), 32-bit and 64-bit layouts differ
+  uint32_t addr_entry_sz;  // sizeof(xdl_addr_entry_t)
+  uint32_t build_id_len;
+  uint32_t name_shift;
+  uint8_t build_id[XDL_CACHE_BUILD_ID_MAX];
+  uint64_t pathname_hash;  // to find the files of older builds
+  uint64_t symtab_cnt;
+  uint64_t strtab_sz;
+  uint64_t addr_cnt;
+  uint64_t file_sz;
+} xdl_cache_header_t;
+
+typedef struct {
+  size_t symtab;
+  size_t strtab;
+  size_t name_idx;
+  size_t name_tags;
+  size_t addr;
+  size_t end;
+} xdl_cache_layout_t;
+
+static int xdl_cache_dir_fd = -1;
+
+void xdl_cache_set_dir(int dir_fd) {
+  __atomic_store_n(&xdl_cache_dir_fd, dir_fd, __ATOMIC_RELEASE);
+}
+
+bool xdl_cache_is_enabled(void) {
+  return __atomic_load_n(&xdl_cache_dir_fd, __ATOMIC_ACQUIRE) >= 0;
+}
+
+static uint64_t xdl_cache_hash(const char *str) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  while (*str) {
+    h ^= (uint8_t)*str++;
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+static void xdl_cache_get_filename(const uint8_t *build_id, size_t build_id_len, char *buf, size_t buf_len) {
+  static const char hex[] = "0123456789abcdef";
+  size_t n = (size_t)snprintf(buf, buf_len, "%s", XDL_CACHE_PREFIX);
+  for (size_t i = 0; i < build_id_len && n + 2 < buf_len; i++) {
+    buf[n++] = hex[build_id[i] >> 4];
+    buf[n++] = hex[build_id[i] & 0xF];
+  }
+  snprintf(buf + n, buf_len - n, "%s", XDL_CACHE_SUFFIX);
+}
+
+static int xdl_cache_get_layout(const xdl_cache_header_t *header, xdl_cache_layout_t *layout) {
+  if (0 != header->name_shift &&
+      (header->name_shift < XDL_CACHE_NAME_SHIFT_MIN || header->name_shift > XDL_CACHE_NAME_SHIFT_MAX))
+    return -1;
+  uint64_t slots = (0 == header->name_shift) ? 0 : ((uint64_t)1 << (32 - header->name_shift));
+  if (header->symtab_cnt > UINT32_MAX || header->strtab_sz > UINT32_MAX ||
+      header->addr_cnt > UINT32_MAX)
+    return -1;
+
+  layout->symtab = XDL_CACHE_ALIGN(sizeof(xdl_cache_header_t));
+  layout->strtab = layout->symtab + (size_t)header->symtab_cnt * header->sym_sz;
+  layout->name_idx = XDL_CACHE_ALIGN(layout->strtab + (size_t)header->strtab_sz);
+  layout->name_tags = layout->name_idx + (size_t)slots * sizeof(uint32_t);
+  layout->addr = XDL_CACHE_ALIGN(layout->name_tags + (size_t)slots);
+  layout->end = layout->addr + (size_t)header->addr_cnt * header->addr_entry_sz;
+  return 0;
+}
+
+size_t xdl_cache_get_build_id(const ElfW(Phdr) *phdr, size_t phnum, uintptr_t load_bias, uint8_t *build_id) {
+  for (size_t i = 0; i < phnum; i++) {
+    if (PT_NOTE != phdr[i].p_type) continue;
+
+    const uint8_t *p = (const uint8_t *)(load_bias + phdr[i].p_vaddr);
+    const uint8_t *end = p + phdr[i].p_memsz;
+    while (p + sizeof(ElfW(Nhdr)) <= end) {
+      const ElfW(Nhdr) *note = (const ElfW(Nhdr) *)p;
+      const uint8_t *name = p + sizeof(ElfW(Nhdr));
+      const uint8_t *desc = name + ((note->n_namesz + 3) & ~3u);
+      const uint8_t *next = desc + ((note->n_descsz + 3) & ~3u);
+      if (next > end) break;
+      if (NT_GNU_BUILD_ID == note->n_type && 4 == note->n_namesz && 0 == memcmp(name, "GNU", 4) &&
+          note->n_descsz > 0 && note->n_descsz <= XDL_CACHE_BUILD_ID_MAX) {
+        memcpy(build_id, desc, note->n_descsz);
+        return note->n_descsz;
+      }
+      p = next;
+    }
+  }
+  return 0;
+}
+
+// the body is trusted by the lookups, check every index once after mapping instead of on each lookup
+static int xdl_cache_check_body(const xdl_cache_header_t *header, const xdl_cache_layout_t *layout,
+                                const uint8_t *data) {
+  const ElfW(Sym) *symtab = (const ElfW(Sym) *)(data + layout->symtab);
+  for (size_t i = 0; i < header->symtab_cnt; i++)
+    if (symtab[i].st_name >= header->strtab_sz) return -1;
+
+  // slot values are .symtab index + 1, and the probe loop stops only at an empty slot
+  if (0 != header->name_shift) {
+    const uint32_t *name_idx = (const uint32_t *)(data + layout->name_idx);
+    size_t slots = (size_t)1 << (32 - header->name_shift);
+    bool has_empty = false;
+    for (size_t j = 0; j < slots; j++) {
+      if (0 == name_idx[j])
+        has_empty = true;
+      else if (name_idx[j] > header->symtab_cnt)
+        return -1;
+    }
+    if (!has_empty) return -1;
+  }
+  return 0;
+}
+
+int xdl_cache_load(const uint8_t *build_id, size_t build_id_len, size_t addr_entry_sz, xdl_cache_symtab_t *symtab,
+                   void **map, size_t *map_sz) {
+  int dir_fd = __atomic_load_n(&xdl_cache_dir_fd, __ATOMIC_ACQUIRE);
+  if (dir_fd < 0 || 0 == build_id_len) return -1;
+
+  char filename[16 + XDL_CACHE_BUILD_ID_MAX * 2];
+  xdl_cache_get_filename(build_id, build_id_len, filename, sizeof(filename));
+  int fd = openat(dir_fd, filename, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return -1;
+  struct stat st;
+  void *data = MAP_FAILED;
+  if (0 == fstat(fd, &st) && (size_t)st.st_size >= sizeof(xdl_cache_header_t))
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (MAP_FAILED == data) return -1;
+  size_t data_sz = (size_t)st.st_size;
+
+  // the file name is only a lookup key, the build-id in the header decides
+  const xdl_cache_header_t *header = (const xdl_cache_header_t *)data;
+  xdl_cache_layout_t layout;
+  if (XDL_CACHE_MAGIC != header->magic || XDL_CACHE_VERSION != header->version ||
+      sizeof(ElfW(Sym)) != header->sym_sz || addr_entry_sz != header->addr_entry_sz ||
+      build_id_len != header->build_id_len || 0 != memcmp(build_id, header->build_id, build_id_len) ||
+      data_sz != header->file_sz || 0 != xdl_cache_get_layout(header, &layout) || layout.end != data_sz ||
+      0 == header->strtab_sz || '\0' != ((const char *)data)[layout.strtab + header->strtab_sz - 1] ||
+      0 != xdl_cache_check_body(header, &layout, (const uint8_t *)data)) {
+    munmap(data, data_sz);
+    return -1;
+  }
+
+  symtab->symtab = (ElfW(Sym) *)((uintptr_t)data + layout.symtab);
+  symtab->symtab_cnt = (size_t)header->symtab_cnt;
+  symtab->strtab = (char *)((uintptr_t)data + layout.strtab);
+  symtab->strtab_sz = (size_t)header->strtab_sz;
+  symtab->name_shift = header->name_shift;
+  symtab->name_idx = (0 == header->name_shift) ? NULL : (uint32_t *)((uintptr_t)data + layout.name_idx);
+  symtab->name_tags = (0 == header->name_shift) ? NULL : (uint8_t *)((uintptr_t)data + layout.name_tags);
+  symtab->addr_cnt = (size_t)header->addr_cnt;
+  symtab->addr_entries = (0 == header->addr_cnt) ? NULL : (void *)((uintptr_t)data + layout.addr);
+  symtab->addr_entry_sz = addr_entry_sz;
+  *map = data;
+  *map_sz = data_sz;
+  return 0;
+}
+
+static int xdl_cache_write(int fd, const void *buf, size_t len) {
+  static const uint8_t zeros[8] = {0};
+  if (NULL == buf) buf = zeros;
+
+  while (len > 0) {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-statement-expression"
+    ssize_t n = XDL_UTIL_TEMP_FAILURE_RETRY(write(fd, buf, len));
+#pragma clang diagnostic pop
+    if (n <= 0) return -1;
+    buf = (const uint8_t *)buf + n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+// remove the files written for older builds of the same pathname
+static void xdl_cache_remove_stale(int dir_fd, const char *keep, uint64_t pathname_hash) {
+  int fd = openat(dir_fd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) return;
+  DIR *dir = fdopendir(fd);
+  if (NULL == dir) {
+    close(fd);
+    return;
+  }
+
+  struct dirent *ent;
+  while (NULL != (ent = readdir(dir))) {
+    if (!xdl_util_starts_with(ent->d_name, XDL_CACHE_PREFIX) || !xdl_util_ends_with(ent->d_name, XDL_CACHE_SUFFIX))
+      continue;
+    if (0 == strcmp(ent->d_name, keep)) continue;
+
+    int file_fd = openat(dir_fd, ent->d_name, O_RDONLY | O_CLOEXEC);
+    if (file_fd < 0) continue;
+    xdl_cache_header_t header;
+    bool stale = sizeof(header) == (size_t)pread(file_fd, &header, sizeof(header), 0) &&
+                 XDL_CACHE_MAGIC == header.magic && pathname_hash == header.pathname_hash;
+    close(file_fd);
+    if (stale) unlinkat(dir_fd, ent->d_name, 0);
+  }
+  closedir(dir);
+}
+
+int xdl_cache_save(const char *pathname, const uint8_t *build_id, size_t build_id_len,
+                   const xdl_cache_symtab_t *symtab) {
+  int dir_fd = __atomic_load_n(&xdl_cache_dir_fd, __ATOMIC_ACQUIRE);
+  if (dir_fd < 0 || 0 == build_id_len || build_id_len > XDL_CACHE_BUILD_ID_MAX) return -1;
+
+  xdl_cache_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = XDL_CACHE_MAGIC;
+  header.version = XDL_CACHE_VERSION;
+  header.sym_sz = sizeof(ElfW(Sym));
+  header.addr_entry_sz = (uint32_t)symtab->addr_entry_sz;
+  header.build_id_len = (uint32_t)build_id_len;
+  header.name_shift = (NULL == symtab->name_idx) ? 0 : symtab->name_shift;
+  memcpy(header.build_id, build_id, build_id_len);
+  header.pathname_hash = xdl_cache_hash(pathname);
+  header.symtab_cnt = symtab->symtab_cnt;
+  header.strtab_sz = symtab->strtab_sz;
+  header.addr_cnt = symtab->addr_cnt;
+  xdl_cache_layout_t layout;
+  if (0 != xdl_cache_get_layout(&header, &layout)) return -1;
+  header.file_sz = layout.end;
+  size_t slots = (0 == header.name_shift) ? 0 : ((size_t)1 << (32 - header.name_shift));
+
+  char filename[16 + XDL_CACHE_BUILD_ID_MAX * 2];
+  char tmp[sizeof(filename) + 16];
+  xdl_cache_get_filename(build_id, build_id_len, filename, sizeof(filename));
+  snprintf(tmp, sizeof(tmp), "%s.%d", filename, getpid());
+  int fd = openat(dir_fd, tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0) return -1;
+
+  // sections in layout order, with zero padding in between
+  size_t pos = 0;
+  int r = -1;
+#define XDL_CACHE_PUT(off, buf, len)                                  \
+  do {                                                                \
+    if (0 != xdl_cache_write(fd, NULL, (off) - pos)) goto end;        \
+    if ((len) > 0 && 0 != xdl_cache_write(fd, (buf), (len))) goto end; \
+    pos = (off) + (len);                                              \
+  } while (0)
+  XDL_CACHE_PUT(0, &header, sizeof(header));
+  XDL_CACHE_PUT(layout.symtab, symtab->symtab, symtab->symtab_cnt * sizeof(ElfW(Sym)));
+  XDL_CACHE_PUT(layout.strtab, symtab->strtab, symtab->strtab_sz);
+  XDL_CACHE_PUT(layout.name_idx, symtab->name_idx, slots * sizeof(uint32_t));
+  XDL_CACHE_PUT(layout.name_tags, symtab->name_tags, slots);
+  XDL_CACHE_PUT(layout.addr, symtab->addr_entries, symtab->addr_cnt * symtab->addr_entry_sz);
+#undef XDL_CACHE_PUT
+  r = 0;
+
+end:
+  close(fd);
+  // concurrent writers produce identical files, whichever rename comes last wins
+  if (0 != r || 0 != renameat(dir_fd, tmp, dir_fd, filename)) {
+    unlinkat(dir_fd, tmp, 0);
+    return -1;
+  }
+  xdl_cache_remove_stale(dir_fd, filename, header.pathname_hash);
+  return 0;
+}
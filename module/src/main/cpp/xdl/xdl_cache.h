@@ -0,0 +1,67 @@
+// Copyright (c) 2020-2021 HexHacking Team
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef IO_HEXHACKING_XDL_CACHE
+#define IO_HEXHACKING_XDL_CACHE
+
+#include <link.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define XDL_CACHE_BUILD_ID_MAX 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// .symtab & .strtab decompressed from .gnu_debugdata, together with their name index and address index
+typedef struct {
+  ElfW(Sym) *symtab;
+  size_t symtab_cnt;
+  char *strtab;
+  size_t strtab_sz;
+  uint32_t *name_idx;  // name hash slots, see xdl_name_index_t in xdl.c
+  uint8_t *name_tags;
+  uint32_t name_shift;
+  void *addr_entries;  // sorted address intervals, see xdl_addr_entry_t in xdl.c
+  size_t addr_cnt;
+  size_t addr_entry_sz;
+} xdl_cache_symtab_t;
+
+void xdl_cache_set_dir(int dir_fd);
+bool xdl_cache_is_enabled(void);
+
+size_t xdl_cache_get_build_id(const ElfW(Phdr) *phdr, size_t phnum, uintptr_t load_bias, uint8_t *build_id);
+
+// map the cache file of the build-id read-only, the pointers in symtab point into the mapping.
+// .symtab and the name index are bounds-checked, the address entries are opaque here and left to the caller
+int xdl_cache_load(const uint8_t *build_id, size_t build_id_len, size_t addr_entry_sz, xdl_cache_symtab_t *symtab,
+                   void **map, size_t *map_sz);
+
+int xdl_cache_save(const char *pathname, const uint8_t *build_id, size_t build_id_len,
+                   const xdl_cache_symtab_t *symtab);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
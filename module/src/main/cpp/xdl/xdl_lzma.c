@@ -23,159 +23,673 @@
 
 #include "xdl_lzma.h"
 
-#include <ctype.h>
-#include <inttypes.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unistd.h>
 
-#include "xdl.h"
-#include "xdl_util.h"
+// Self-contained XZ decoder for .gnu_debugdata (MiniDebugInfo), no system liblzma needed.
+//
+// Supports what MiniDebugInfo uses: one or more concatenated XZ streams whose blocks carry the
+// single LZMA2 filter. CRC32 and CRC64 checks are verified, other check types are skipped.
+// The stream indexes are read first, so the output buffer is allocated once with the exact size,
+// and that buffer doubles as the LZMA dictionary.
+
+#define XDL_LZMA_CRC32_POLY 0xEDB88320u
+#define XDL_LZMA_CRC64_POLY 0xC96C5795D7870F42ull
+
+#define XDL_LZMA_STREAM_HEADER_SIZE 12
+#define XDL_LZMA_STREAM_FOOTER_SIZE 12
+#define XDL_LZMA_FILTER_LZMA2       0x21
+
+#define XDL_LZMA_CHECK_NONE  0x00
+#define XDL_LZMA_CHECK_CRC32 0x01
+#define XDL_LZMA_CHECK_CRC64 0x04
+
+#define XDL_LZMA_STATES       12
+#define XDL_LZMA_LIT_STATES   7
+#define XDL_LZMA_POS_STATES   16
+#define XDL_LZMA_DIST_STATES  4
+#define XDL_LZMA_DIST_SLOTS   64
+#define XDL_LZMA_DIST_SPECIAL 115  // distances of slot 4 ~ 13, indexed from 1
+#define XDL_LZMA_ALIGN_SIZE   16
+#define XDL_LZMA_LIT_SIZE     0x300
+#define XDL_LZMA_LCLP_MAX     4
+#define XDL_LZMA_PROB_INIT    1024
 
-// LZMA library pathname & symbol names
-#ifndef __LP64__
-#define XDL_LZMA_PATHNAME "/system/lib/liblzma.so"
-#else
-#define XDL_LZMA_PATHNAME "/system/lib64/liblzma.so"
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define XDL_LZMA_LITTLE_ENDIAN 1
 #endif
-#define XDL_LZMA_SYM_CRCGEN     "CrcGenerateTable"
-#define XDL_LZMA_SYM_CRC64GEN   "Crc64GenerateTable"
-#define XDL_LZMA_SYM_CONSTRUCT  "XzUnpacker_Construct"
-#define XDL_LZMA_SYM_ISFINISHED "XzUnpacker_IsStreamWasFinished"
-#define XDL_LZMA_SYM_FREE       "XzUnpacker_Free"
-#define XDL_LZMA_SYM_CODE       "XzUnpacker_Code"
-
-// LZMA data type definition
-#define SZ_OK 0
-typedef struct ISzAlloc ISzAlloc;
-typedef const ISzAlloc *ISzAllocPtr;
-struct ISzAlloc {
-  void *(*Alloc)(ISzAllocPtr p, size_t size);
-  void (*Free)(ISzAllocPtr p, void *address); /* address can be 0 */
-};
-typedef enum {
-  CODER_STATUS_NOT_SPECIFIED,      /* use main error code instead */
-  CODER_STATUS_FINISHED_WITH_MARK, /* stream was finished with end mark. */
-  CODER_STATUS_NOT_FINISHED,       /* stream was not finished */
-  CODER_STATUS_NEEDS_MORE_INPUT    /* you must provide more input bytes */
-} ECoderStatus;
-typedef enum {
-  CODER_FINISH_ANY, /* finish at any point */
-  CODER_FINISH_END  /* block must be finished at the end */
-} ECoderFinishMode;
-
-// LZMA function type definition
-typedef void (*xdl_lzma_crcgen_t)(void);
-typedef void (*xdl_lzma_crc64gen_t)(void);
-typedef void (*xdl_lzma_construct_t)(void *, ISzAllocPtr);
-typedef int (*xdl_lzma_isfinished_t)(const void *);
-typedef void (*xdl_lzma_free_t)(void *);
-typedef int (*xdl_lzma_code_t)(void *, uint8_t *, size_t *, const uint8_t *, size_t *, ECoderFinishMode,
-                               ECoderStatus *);
-typedef int (*xdl_lzma_code_q_t)(void *, uint8_t *, size_t *, const uint8_t *, size_t *, int,
-                                 ECoderFinishMode, ECoderStatus *);
-
-// LZMA function pointor
-static xdl_lzma_construct_t xdl_lzma_construct = NULL;
-static xdl_lzma_isfinished_t xdl_lzma_isfinished = NULL;
-static xdl_lzma_free_t xdl_lzma_free = NULL;
-static void *xdl_lzma_code = NULL;
-
-// LZMA init
-static void xdl_lzma_init() {
-  void *lzma = xdl_open(XDL_LZMA_PATHNAME, XDL_TRY_FORCE_LOAD);
-  if (NULL == lzma) return;
-
-  xdl_lzma_crcgen_t crcgen = NULL;
-  xdl_lzma_crc64gen_t crc64gen = NULL;
-  if (NULL == (crcgen = (xdl_lzma_crcgen_t)xdl_sym(lzma, XDL_LZMA_SYM_CRCGEN, NULL))) goto end;
-  if (NULL == (crc64gen = (xdl_lzma_crc64gen_t)xdl_sym(lzma, XDL_LZMA_SYM_CRC64GEN, NULL))) goto end;
-  if (NULL == (xdl_lzma_construct = (xdl_lzma_construct_t)xdl_sym(lzma, XDL_LZMA_SYM_CONSTRUCT, NULL)))
-    goto end;
-  if (NULL == (xdl_lzma_isfinished = (xdl_lzma_isfinished_t)xdl_sym(lzma, XDL_LZMA_SYM_ISFINISHED, NULL)))
-    goto end;
-  if (NULL == (xdl_lzma_free = (xdl_lzma_free_t)xdl_sym(lzma, XDL_LZMA_SYM_FREE, NULL))) goto end;
-  if (NULL == (xdl_lzma_code = xdl_sym(lzma, XDL_LZMA_SYM_CODE, NULL))) goto end;
-  crcgen();
-  crc64gen();
 
-end:
-  xdl_close(lzma);
+static const uint8_t xdl_lzma_stream_magic[6] = {0xFD, '7', 'z', 'X', 'Z', 0x00};
+static const uint8_t xdl_lzma_check_sizes[16] = {0, 4, 4, 4, 8, 8, 8, 16, 16, 16, 32, 32, 32, 64, 64, 64};
+
+//
+// CRC32 / CRC64 (slice-by-8)
+//
+
+static uint32_t xdl_lzma_crc32_table[8][256];
+static uint64_t xdl_lzma_crc64_table[8][256];
+static pthread_once_t xdl_lzma_crc_once = PTHREAD_ONCE_INIT;
+
+static void xdl_lzma_crc_init(void) {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc32 = i;
+    uint64_t crc64 = i;
+    for (int j = 0; j < 8; j++) {
+      crc32 = (crc32 >> 1) ^ ((crc32 & 1) ? XDL_LZMA_CRC32_POLY : 0);
+      crc64 = (crc64 >> 1) ^ ((crc64 & 1) ? XDL_LZMA_CRC64_POLY : 0);
+    }
+    xdl_lzma_crc32_table[0][i] = crc32;
+    xdl_lzma_crc64_table[0][i] = crc64;
+  }
+
+  for (uint32_t i = 0; i < 256; i++) {
+    for (int k = 1; k < 8; k++) {
+      uint32_t crc32 = xdl_lzma_crc32_table[k - 1][i];
+      uint64_t crc64 = xdl_lzma_crc64_table[k - 1][i];
+      xdl_lzma_crc32_table[k][i] = (crc32 >> 8) ^ xdl_lzma_crc32_table[0][crc32 & 0xFF];
+      xdl_lzma_crc64_table[k][i] = (crc64 >> 8) ^ xdl_lzma_crc64_table[0][crc64 & 0xFF];
+    }
+  }
+}
+
+static uint32_t xdl_lzma_crc32(const uint8_t *buf, size_t len) {
+  uint32_t crc = 0xFFFFFFFFu;
+
+#ifdef XDL_LZMA_LITTLE_ENDIAN
+  while (len >= 8) {
+    uint32_t lo, hi;
+    memcpy(&lo, buf, 4);
+    memcpy(&hi, buf + 4, 4);
+    lo ^= crc;
+    crc = xdl_lzma_crc32_table[7][lo & 0xFF] ^ xdl_lzma_crc32_table[6][(lo >> 8) & 0xFF] ^
+          xdl_lzma_crc32_table[5][(lo >> 16) & 0xFF] ^ xdl_lzma_crc32_table[4][lo >> 24] ^
+          xdl_lzma_crc32_table[3][hi & 0xFF] ^ xdl_lzma_crc32_table[2][(hi >> 8) & 0xFF] ^
+          xdl_lzma_crc32_table[1][(hi >> 16) & 0xFF] ^ xdl_lzma_crc32_table[0][hi >> 24];
+    buf += 8;
+    len -= 8;
+  }
+#endif
+
+  while (len-- > 0) crc = xdl_lzma_crc32_table[0][(crc ^ *buf++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
 }
 
-// LZMA internal alloc / free
-static void *xdl_lzma_internal_alloc(ISzAllocPtr p, size_t size) {
-  (void)p;
-  return malloc(size);
+static uint64_t xdl_lzma_crc64(const uint8_t *buf, size_t len) {
+  uint64_t crc = 0xFFFFFFFFFFFFFFFFull;
+
+#ifdef XDL_LZMA_LITTLE_ENDIAN
+  while (len >= 8) {
+    uint64_t v;
+    memcpy(&v, buf, 8);
+    crc ^= v;
+    crc = xdl_lzma_crc64_table[7][crc & 0xFF] ^ xdl_lzma_crc64_table[6][(crc >> 8) & 0xFF] ^
+          xdl_lzma_crc64_table[5][(crc >> 16) & 0xFF] ^ xdl_lzma_crc64_table[4][(crc >> 24) & 0xFF] ^
+          xdl_lzma_crc64_table[3][(crc >> 32) & 0xFF] ^ xdl_lzma_crc64_table[2][(crc >> 40) & 0xFF] ^
+          xdl_lzma_crc64_table[1][(crc >> 48) & 0xFF] ^ xdl_lzma_crc64_table[0][crc >> 56];
+    buf += 8;
+    len -= 8;
+  }
+#endif
+
+  while (len-- > 0) crc = xdl_lzma_crc64_table[0][(crc ^ *buf++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
 }
-static void xdl_lzma_internal_free(ISzAllocPtr p, void *address) {
-  (void)p;
-  free(address);
+
+static uint32_t xdl_lzma_le32(const uint8_t *buf) {
+  return (uint32_t)buf[0] | (uint32_t)buf[1] << 8 | (uint32_t)buf[2] << 16 | (uint32_t)buf[3] << 24;
 }
 
-int xdl_lzma_decompress(uint8_t *src, size_t src_size, uint8_t **dst, size_t *dst_size) {
-  size_t src_offset = 0;
-  size_t dst_offset = 0;
-  size_t src_remaining;
-  size_t dst_remaining;
-  ISzAlloc alloc = {.Alloc = xdl_lzma_internal_alloc, .Free = xdl_lzma_internal_free};
-  long long state[4096 / sizeof(long long)];  // must be enough, 8-bit aligned
-  ECoderStatus status;
-  int api_level = xdl_util_get_api_level();
-
-  // init and check
-  static bool inited = false;
-  if (!inited) {
-    xdl_lzma_init();
-    inited = true;
-  }
-  if (NULL == xdl_lzma_code) return -1;
-
-  xdl_lzma_construct(&state, &alloc);
-
-  *dst_size = 2 * src_size;
-  *dst = NULL;
-  do {
-    *dst_size *= 2;
-    if (NULL == (*dst = realloc(*dst, *dst_size))) {
-      xdl_lzma_free(&state);
-      return -1;
+static uint64_t xdl_lzma_le64(const uint8_t *buf) {
+  return (uint64_t)xdl_lzma_le32(buf) | (uint64_t)xdl_lzma_le32(buf + 4) << 32;
+}
+
+// multibyte integer used by block headers and indexes
+static int xdl_lzma_varint(const uint8_t *buf, size_t size, size_t *pos, uint64_t *value) {
+  uint64_t v = 0;
+  for (size_t i = 0; i < 9; i++) {
+    if (*pos >= size) return -1;
+    uint8_t b = buf[(*pos)++];
+    v |= (uint64_t)(b & 0x7F) << (i * 7);
+    if (0 == (b & 0x80)) {
+      if (0 == b && i > 0) return -1;  // not the shortest encoding
+      *value = v;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+//
+// range decoder
+//
+
+typedef struct {
+  uint32_t range;
+  uint32_t code;
+  const uint8_t *in;
+  size_t in_pos;
+  size_t in_size;
+} xdl_lzma_rc_t;
+
+static int xdl_lzma_rc_init(xdl_lzma_rc_t *rc, const uint8_t *in, size_t in_size) {
+  if (in_size < 5 || 0 != in[0]) return -1;
+  rc->range = 0xFFFFFFFFu;
+  rc->code = (uint32_t)in[1] << 24 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 8 | (uint32_t)in[4];
+  rc->in = in;
+  rc->in_pos = 5;
+  rc->in_size = in_size;
+  return 0;
+}
+
+// reading past the chunk yields zeros, the overrun is caught by xdl_lzma_rc_is_finished()
+static inline void xdl_lzma_rc_normalize(xdl_lzma_rc_t *rc) {
+  if (rc->range < (1u << 24)) {
+    rc->range <<= 8;
+    rc->code = (rc->code << 8) | (rc->in_pos < rc->in_size ? rc->in[rc->in_pos] : 0);
+    rc->in_pos++;
+  }
+}
+
+static bool xdl_lzma_rc_is_finished(xdl_lzma_rc_t *rc) {
+  xdl_lzma_rc_normalize(rc);
+  return rc->in_pos == rc->in_size && 0 == rc->code;
+}
+
+static inline uint32_t xdl_lzma_rc_bit(xdl_lzma_rc_t *rc, uint16_t *prob) {
+  xdl_lzma_rc_normalize(rc);
+  uint32_t bound = (rc->range >> 11) * *prob;
+  if (rc->code < bound) {
+    rc->range = bound;
+    *prob = (uint16_t)(*prob + ((2048 - *prob) >> 5));
+    return 0;
+  } else {
+    rc->range -= bound;
+    rc->code -= bound;
+    *prob = (uint16_t)(*prob - (*prob >> 5));
+    return 1;
+  }
+}
+
+static inline uint32_t xdl_lzma_rc_bittree(xdl_lzma_rc_t *rc, uint16_t *probs, uint32_t bits) {
+  uint32_t m = 1;
+  for (uint32_t i = 0; i < bits; i++) m = (m << 1) | xdl_lzma_rc_bit(rc, &probs[m]);
+  return m - ((uint32_t)1 << bits);
+}
+
+static inline uint32_t xdl_lzma_rc_bittree_reverse(xdl_lzma_rc_t *rc, uint16_t *probs, uint32_t bits) {
+  uint32_t m = 1, symbol = 0;
+  for (uint32_t i = 0; i < bits; i++) {
+    uint32_t bit = xdl_lzma_rc_bit(rc, &probs[m]);
+    m = (m << 1) | bit;
+    symbol |= bit << i;
+  }
+  return symbol;
+}
+
+static inline uint32_t xdl_lzma_rc_direct(xdl_lzma_rc_t *rc, uint32_t bits) {
+  uint32_t v = 0;
+  while (bits-- > 0) {
+    xdl_lzma_rc_normalize(rc);
+    rc->range >>= 1;
+    if (rc->code >= rc->range) {
+      rc->code -= rc->range;
+      v = (v << 1) | 1;
+    } else {
+      v <<= 1;
+    }
+  }
+  return v;
+}
+
+//
+// LZMA decoder
+//
+
+typedef struct {
+  uint16_t choice;
+  uint16_t choice2;
+  uint16_t low[XDL_LZMA_POS_STATES][8];
+  uint16_t mid[XDL_LZMA_POS_STATES][8];
+  uint16_t high[256];
+} xdl_lzma_len_probs_t;
+
+typedef struct {
+  uint16_t is_match[XDL_LZMA_STATES][XDL_LZMA_POS_STATES];
+  uint16_t is_rep[XDL_LZMA_STATES];
+  uint16_t is_rep0[XDL_LZMA_STATES];
+  uint16_t is_rep1[XDL_LZMA_STATES];
+  uint16_t is_rep2[XDL_LZMA_STATES];
+  uint16_t is_rep0_long[XDL_LZMA_STATES][XDL_LZMA_POS_STATES];
+  uint16_t dist_slot[XDL_LZMA_DIST_STATES][XDL_LZMA_DIST_SLOTS];
+  uint16_t dist_special[XDL_LZMA_DIST_SPECIAL];
+  uint16_t dist_align[XDL_LZMA_ALIGN_SIZE];
+  xdl_lzma_len_probs_t match_len;
+  xdl_lzma_len_probs_t rep_len;
+  uint16_t literal[XDL_LZMA_LIT_SIZE << XDL_LZMA_LCLP_MAX];  // only (0x300 << (lc + lp)) are used
+} xdl_lzma_probs_t;
+
+typedef struct {
+  uint32_t lc;
+  uint32_t lp;
+  uint32_t pb;
+  uint32_t state;
+  uint32_t rep0, rep1, rep2, rep3;
+  xdl_lzma_probs_t probs;
+} xdl_lzma_dec_t;
+
+static int xdl_lzma_set_props(xdl_lzma_dec_t *d, uint8_t props) {
+  if (props >= 9 * 5 * 5) return -1;
+  d->lc = props % 9;
+  props /= 9;
+  d->lp = props % 5;
+  d->pb = props / 5;
+  return d->lc + d->lp > XDL_LZMA_LCLP_MAX ? -1 : 0;
+}
+
+static void xdl_lzma_reset(xdl_lzma_dec_t *d) {
+  size_t cnt = offsetof(xdl_lzma_probs_t, literal) / sizeof(uint16_t) + (XDL_LZMA_LIT_SIZE << (d->lc + d->lp));
+  uint16_t *probs = (uint16_t *)&d->probs;
+  for (size_t i = 0; i < cnt; i++) probs[i] = XDL_LZMA_PROB_INIT;
+  d->state = 0;
+  d->rep0 = d->rep1 = d->rep2 = d->rep3 = 0;
+}
+
+// returns match length - 2
+static inline uint32_t xdl_lzma_len(xdl_lzma_rc_t *rc, xdl_lzma_len_probs_t *probs, uint32_t pos_state) {
+  if (!xdl_lzma_rc_bit(rc, &probs->choice)) return xdl_lzma_rc_bittree(rc, probs->low[pos_state], 3);
+  if (!xdl_lzma_rc_bit(rc, &probs->choice2)) return 8 + xdl_lzma_rc_bittree(rc, probs->mid[pos_state], 3);
+  return 16 + xdl_lzma_rc_bittree(rc, probs->high, 8);
+}
+
+// decode one LZMA chunk into buf[*pos, end), buf[dict_start, *pos) is the dictionary
+static int xdl_lzma_decode_chunk(xdl_lzma_dec_t *d, xdl_lzma_rc_t *rc_io, uint8_t *buf, size_t dict_start,
+                                 size_t *pos_io, size_t end) {
+  // local copies keep the hot state in registers
+  xdl_lzma_rc_t rc_local = *rc_io;
+  xdl_lzma_rc_t *rc = &rc_local;
+  xdl_lzma_probs_t *p = &d->probs;
+  uint32_t lc = d->lc;
+  uint32_t lp_mask = ((uint32_t)1 << d->lp) - 1;
+  uint32_t pb_mask = ((uint32_t)1 << d->pb) - 1;
+  uint32_t state = d->state;
+  uint32_t rep0 = d->rep0, rep1 = d->rep1, rep2 = d->rep2, rep3 = d->rep3;
+  size_t pos = *pos_io;
+  int r = -1;
+
+  while (pos < end) {
+    size_t dict_len = pos - dict_start;
+    uint32_t pos_state = (uint32_t)dict_len & pb_mask;
+
+    // literal
+    if (!xdl_lzma_rc_bit(rc, &p->is_match[state][pos_state])) {
+      uint32_t prev = dict_len > 0 ? buf[pos - 1] : 0;
+      uint16_t *probs = p->literal + XDL_LZMA_LIT_SIZE * ((((uint32_t)dict_len & lp_mask) << lc) + (prev >> (8 - lc)));
+      uint32_t symbol = 1;
+      if (state < XDL_LZMA_LIT_STATES) {
+        do symbol = (symbol << 1) | xdl_lzma_rc_bit(rc, &probs[symbol]);
+        while (symbol < 0x100);
+      } else {
+        // the previous symbol was a match, so rep0 has been checked against dict_len
+        uint32_t match_byte = (uint32_t)buf[pos - rep0 - 1] << 1;
+        uint32_t offset = 0x100;
+        do {
+          uint32_t match_bit = match_byte & offset;
+          match_byte <<= 1;
+          if (xdl_lzma_rc_bit(rc, &probs[offset + match_bit + symbol])) {
+            symbol = (symbol << 1) | 1;
+            offset = match_bit;
+          } else {
+            symbol <<= 1;
+            offset &= ~match_bit;
+          }
+        } while (symbol < 0x100);
+      }
+      buf[pos++] = (uint8_t)symbol;
+      state = state < 4 ? 0 : (state < 10 ? state - 3 : state - 6);
+      continue;
     }
 
-    src_remaining = src_size - src_offset;
-    dst_remaining = *dst_size - dst_offset;
+    uint32_t len;
+    if (!xdl_lzma_rc_bit(rc, &p->is_rep[state])) {
+      // simple match
+      len = xdl_lzma_len(rc, &p->match_len, pos_state);
+      rep3 = rep2;
+      rep2 = rep1;
+      rep1 = rep0;
+      state = state < XDL_LZMA_LIT_STATES ? 7 : 10;
 
-    int result;
-    if (api_level >= __ANDROID_API_Q__) {
-      xdl_lzma_code_q_t lzma_code_q = (xdl_lzma_code_q_t)xdl_lzma_code;
-      result = lzma_code_q(&state, *dst + dst_offset, &dst_remaining, src + src_offset, &src_remaining, 1,
-                           CODER_FINISH_ANY, &status);
+      uint32_t slot = xdl_lzma_rc_bittree(rc, p->dist_slot[len < XDL_LZMA_DIST_STATES ? len : XDL_LZMA_DIST_STATES - 1], 6);
+      if (slot < 4) {
+        rep0 = slot;
+      } else {
+        uint32_t limit = (slot >> 1) - 1;
+        rep0 = (2 | (slot & 1)) << limit;
+        if (slot < 14) {
+          rep0 += xdl_lzma_rc_bittree_reverse(rc, p->dist_special + rep0 - slot, limit);
+        } else {
+          rep0 += xdl_lzma_rc_direct(rc, limit - 4) << 4;
+          rep0 += xdl_lzma_rc_bittree_reverse(rc, p->dist_align, 4);
+        }
+      }
     } else {
-      xdl_lzma_code_t lzma_code = (xdl_lzma_code_t)xdl_lzma_code;
-      result = lzma_code(&state, *dst + dst_offset, &dst_remaining, src + src_offset, &src_remaining,
-                         CODER_FINISH_ANY, &status);
+      if (!xdl_lzma_rc_bit(rc, &p->is_rep0[state])) {
+        if (!xdl_lzma_rc_bit(rc, &p->is_rep0_long[state][pos_state])) {
+          // short rep: one byte at rep0
+          state = state < XDL_LZMA_LIT_STATES ? 9 : 11;
+          if (rep0 >= dict_len) goto end;
+          buf[pos] = buf[pos - rep0 - 1];
+          pos++;
+          continue;
+        }
+      } else {
+        uint32_t dist;
+        if (!xdl_lzma_rc_bit(rc, &p->is_rep1[state])) {
+          dist = rep1;
+        } else {
+          if (!xdl_lzma_rc_bit(rc, &p->is_rep2[state])) {
+            dist = rep2;
+          } else {
+            dist = rep3;
+            rep3 = rep2;
+          }
+          rep2 = rep1;
+        }
+        rep1 = rep0;
+        rep0 = dist;
+      }
+      len = xdl_lzma_len(rc, &p->rep_len, pos_state);
+      state = state < XDL_LZMA_LIT_STATES ? 8 : 11;
+    }
+
+    // copy the match, LZMA2 neither has end markers nor lets a match cross chunks
+    len += 2;
+    if (rep0 >= dict_len || len > end - pos) goto end;
+    uint8_t *dst = buf + pos;
+    const uint8_t *src = dst - rep0 - 1;
+    if (rep0 + 1 >= len) {
+      memcpy(dst, src, len);
+    } else {
+      for (uint32_t i = 0; i < len; i++) dst[i] = src[i];
+    }
+    pos += len;
+  }
+  r = 0;
+
+end:
+  *rc_io = rc_local;
+  d->state = state;
+  d->rep0 = rep0;
+  d->rep1 = rep1;
+  d->rep2 = rep2;
+  d->rep3 = rep3;
+  *pos_io = pos;
+  return r;
+}
+
+// decode LZMA2 data into buf[*pos_io, end), returns the number of input bytes used in *in_used
+static int xdl_lzma2_decode(xdl_lzma_dec_t *d, const uint8_t *in, size_t in_size, size_t *in_used, uint8_t *buf,
+                            size_t *pos_io, size_t end) {
+  size_t i = 0;
+  size_t pos = *pos_io;
+  size_t dict_start = pos;
+  bool need_dict_reset = true;
+  bool need_props = true;
+
+  while (1) {
+    if (i >= in_size) return -1;
+    uint8_t control = in[i++];
+    if (0x00 == control) break;
+
+    // 0x01 and LZMA chunks with reset 3 start a new dictionary; like liblzma, a dictionary reset by 0x01
+    // also requires the next LZMA chunk to carry new properties
+    if (0x01 == control || control >= 0xE0) {
+      dict_start = pos;
+      need_dict_reset = false;
+      if (0x01 == control) need_props = true;
+    } else if (need_dict_reset) {
+      return -1;
     }
-    if (SZ_OK != result) {
-      free(*dst);
-      xdl_lzma_free(&state);
+
+    // uncompressed chunk
+    if (control < 0x80) {
+      if (control > 0x02 || in_size - i < 2) return -1;
+      size_t size = ((size_t)in[i] << 8 | in[i + 1]) + 1;
+      i += 2;
+      if (size > in_size - i || size > end - pos) return -1;
+      memcpy(buf + pos, in + i, size);
+      pos += size;
+      i += size;
+      continue;
+    }
+
+    // LZMA chunk
+    if (in_size - i < 4) return -1;
+    size_t usize = (((size_t)control & 0x1F) << 16 | (size_t)in[i] << 8 | in[i + 1]) + 1;
+    size_t csize = ((size_t)in[i + 2] << 8 | in[i + 3]) + 1;
+    i += 4;
+    uint32_t reset = (control >> 5) & 0x03;
+    if (reset >= 2) {
+      if (i >= in_size || 0 != xdl_lzma_set_props(d, in[i++])) return -1;
+      need_props = false;
+    } else if (need_props) {
       return -1;
     }
+    if (reset >= 1) xdl_lzma_reset(d);
+    if (csize > in_size - i || usize > end - pos) return -1;
 
-    src_offset += src_remaining;
-    dst_offset += dst_remaining;
-  } while (status == CODER_STATUS_NOT_FINISHED);
+    xdl_lzma_rc_t rc;
+    if (0 != xdl_lzma_rc_init(&rc, in + i, csize)) return -1;
+    if (0 != xdl_lzma_decode_chunk(d, &rc, buf, dict_start, &pos, pos + usize)) return -1;
+    if (!xdl_lzma_rc_is_finished(&rc)) return -1;
+    i += csize;
+  }
+
+  *in_used = i;
+  *pos_io = pos;
+  return 0;
+}
 
-  xdl_lzma_free(&state);
+//
+// XZ container
+//
+
+static int xdl_lzma_block(xdl_lzma_dec_t *d, const uint8_t *src, size_t src_size, size_t *off_io,
+                          uint8_t check_type, uint8_t *buf, size_t *pos_io, size_t end, uint64_t *unpadded) {
+  size_t off = *off_io;
+  size_t pos = *pos_io;
+
+  // block header
+  size_t header_size = ((size_t)src[off] + 1) * 4;
+  if (header_size > src_size - off) return -1;
+  const uint8_t *header = src + off;
+  size_t header_end = header_size - 4;
+  if (xdl_lzma_crc32(header, header_end) != xdl_lzma_le32(header + header_end)) return -1;
+  uint8_t flags = header[1];
+  if (0 != (flags & 0x3F)) return -1;  // reserved bits, or more than one filter
+
+  size_t i = 2;
+  uint64_t csize = UINT64_MAX, usize = UINT64_MAX, filter, props_size;
+  if ((flags & 0x40) && 0 != xdl_lzma_varint(header, header_end, &i, &csize)) return -1;
+  if ((flags & 0x80) && 0 != xdl_lzma_varint(header, header_end, &i, &usize)) return -1;
+  if (0 != xdl_lzma_varint(header, header_end, &i, &filter) || XDL_LZMA_FILTER_LZMA2 != filter) return -1;
+  if (0 != xdl_lzma_varint(header, header_end, &i, &props_size) || 1 != props_size) return -1;
+  if (i >= header_end || header[i++] > 40) return -1;  // dictionary size, not needed by this decoder
+  for (; i < header_end; i++)
+    if (0 != header[i]) return -1;
+  off += header_size;
+
+  // compressed data
+  size_t in_size = src_size - off;
+  if (UINT64_MAX != csize) {
+    if (csize > in_size) return -1;
+    in_size = (size_t)csize;
+  }
+  if (UINT64_MAX != usize) {
+    if (usize > end - pos) return -1;
+    end = pos + (size_t)usize;
+  }
+  size_t in_used;
+  size_t block_start = pos;
+  if (0 != xdl_lzma2_decode(d, src + off, in_size, &in_used, buf, &pos, end)) return -1;
+  if (UINT64_MAX != csize && csize != in_used) return -1;
+  if (UINT64_MAX != usize && usize != pos - block_start) return -1;
+  off += in_used;
 
-  if (!xdl_lzma_isfinished(&state)) {
-    free(*dst);
+  // block padding
+  for (size_t padded = in_used; 0 != (padded & 3); padded++, off++)
+    if (off >= src_size || 0 != src[off]) return -1;
+
+  // check
+  size_t check_size = xdl_lzma_check_sizes[check_type];
+  if (check_size > src_size - off) return -1;
+  if (XDL_LZMA_CHECK_CRC32 == check_type) {
+    if (xdl_lzma_crc32(buf + block_start, pos - block_start) != xdl_lzma_le32(src + off)) return -1;
+  } else if (XDL_LZMA_CHECK_CRC64 == check_type) {
+    if (xdl_lzma_crc64(buf + block_start, pos - block_start) != xdl_lzma_le64(src + off)) return -1;
+  }
+  off += check_size;
+
+  *unpadded = header_size + in_used + check_size;
+  *off_io = off;
+  *pos_io = pos;
+  return 0;
+}
+
+typedef struct {
+  uint64_t count;
+  uint64_t blocks_size;   // sum of the padded block sizes
+  uint64_t uncompressed;  // sum of the uncompressed block sizes
+} xdl_lzma_index_t;
+
+// parse the index at src, returns its size
+static size_t xdl_lzma_index(const uint8_t *src, size_t src_size, xdl_lzma_index_t *index) {
+  size_t i = 0;
+  uint64_t count;
+  if (0 == src_size || 0x00 != src[i++]) return 0;
+  if (0 != xdl_lzma_varint(src, src_size, &i, &count)) return 0;
+
+  index->count = count;
+  index->blocks_size = 0;
+  index->uncompressed = 0;
+  for (uint64_t k = 0; k < count; k++) {
+    uint64_t unpadded, uncompressed;
+    if (0 != xdl_lzma_varint(src, src_size, &i, &unpadded) || unpadded < 5 || unpadded > (UINT64_MAX >> 2)) return 0;
+    if (0 != xdl_lzma_varint(src, src_size, &i, &uncompressed)) return 0;
+    uint64_t padded = (unpadded + 3) & ~(uint64_t)3;
+    if (index->blocks_size + padded < index->blocks_size) return 0;
+    if (index->uncompressed + uncompressed < index->uncompressed) return 0;
+    index->blocks_size += padded;
+    index->uncompressed += uncompressed;
+  }
+  for (; 0 != (i & 3); i++)
+    if (i >= src_size || 0 != src[i]) return 0;
+  if (src_size - i < 4 || xdl_lzma_crc32(src, i) != xdl_lzma_le32(src + i)) return 0;
+  return i + 4;
+}
+
+static bool xdl_lzma_stream_header_is_valid(const uint8_t *header) {
+  return 0 == memcmp(header, xdl_lzma_stream_magic, sizeof(xdl_lzma_stream_magic)) && 0x00 == header[6] &&
+         0 == (header[7] & 0xF0) && xdl_lzma_crc32(header + 6, 2) == xdl_lzma_le32(header + 8);
+}
+
+// walk the streams backwards through their footers and indexes, sum the uncompressed size
+static int xdl_lzma_get_size(const uint8_t *src, size_t src_size, uint64_t *size) {
+  uint64_t total = 0;
+  size_t end = src_size;
+
+  if (0 != (src_size & 3)) return -1;
+  while (end > 0) {
+    // stream padding
+    while (end >= 4 && 0 == xdl_lzma_le32(src + end - 4)) end -= 4;
+    if (end < XDL_LZMA_STREAM_HEADER_SIZE + XDL_LZMA_STREAM_FOOTER_SIZE) return -1;
+
+    // stream footer
+    const uint8_t *footer = src + end - XDL_LZMA_STREAM_FOOTER_SIZE;
+    if ('Y' != footer[10] || 'Z' != footer[11]) return -1;
+    if (xdl_lzma_crc32(footer + 4, 6) != xdl_lzma_le32(footer)) return -1;
+    size_t index_size = ((size_t)xdl_lzma_le32(footer + 4) + 1) * 4;
+    if (index_size > end - XDL_LZMA_STREAM_HEADER_SIZE - XDL_LZMA_STREAM_FOOTER_SIZE) return -1;
+
+    // index
+    size_t index_off = end - XDL_LZMA_STREAM_FOOTER_SIZE - index_size;
+    xdl_lzma_index_t index;
+    if (index_size != xdl_lzma_index(src + index_off, index_size, &index)) return -1;
+    if (index.blocks_size > index_off - XDL_LZMA_STREAM_HEADER_SIZE) return -1;
+
+    // stream header
+    size_t stream_off = index_off - (size_t)index.blocks_size - XDL_LZMA_STREAM_HEADER_SIZE;
+    const uint8_t *header = src + stream_off;
+    if (!xdl_lzma_stream_header_is_valid(header) || 0 != memcmp(header + 6, footer + 8, 2)) return -1;
+
+    if (total + index.uncompressed < total) return -1;
+    total += index.uncompressed;
+    end = stream_off;
+  }
+
+  *size = total;
+  return 0;
+}
+
+int xdl_lzma_decompress(uint8_t *src, size_t src_size, uint8_t **dst, size_t *dst_size) {
+  pthread_once(&xdl_lzma_crc_once, xdl_lzma_crc_init);
+
+  // get the exact output size, then allocate once
+  uint64_t total;
+  if (0 != xdl_lzma_get_size(src, src_size, &total)) return -1;
+  if (0 == total || total > SIZE_MAX) return -1;
+  uint8_t *buf = malloc((size_t)total);
+  if (NULL == buf) return -1;
+  xdl_lzma_dec_t *d = malloc(sizeof(xdl_lzma_dec_t));
+  if (NULL == d) {
+    free(buf);
     return -1;
   }
 
-  *dst_size = dst_offset;
-  *dst = realloc(*dst, *dst_size);
+  size_t off = 0;
+  size_t pos = 0;
+  size_t end = (size_t)total;
+  while (off < src_size) {
+    // stream padding
+    if (0 == xdl_lzma_le32(src + off)) {
+      off += 4;
+      continue;
+    }
+
+    // stream header (checked by xdl_lzma_get_size())
+    uint8_t check_type = src[off + 7] & 0x0F;
+    off += XDL_LZMA_STREAM_HEADER_SIZE;
+
+    // blocks, until the index indicator
+    xdl_lzma_index_t decoded = {0, 0, 0};
+    while (off < src_size && 0x00 != src[off]) {
+      size_t block_start = pos;
+      uint64_t unpadded;
+      if (0 != xdl_lzma_block(d, src, src_size, &off, check_type, buf, &pos, end, &unpadded)) goto err;
+      decoded.count++;
+      decoded.blocks_size += (unpadded + 3) & ~(uint64_t)3;
+      decoded.uncompressed += pos - block_start;
+    }
+
+    // index must describe the blocks just decoded
+    xdl_lzma_index_t index;
+    size_t index_size = off < src_size ? xdl_lzma_index(src + off, src_size - off, &index) : 0;
+    if (0 == index_size || index.count != decoded.count || index.blocks_size != decoded.blocks_size ||
+        index.uncompressed != decoded.uncompressed)
+      goto err;
+    off += index_size + XDL_LZMA_STREAM_FOOTER_SIZE;
+  }
+  if (pos != end) goto err;
+
+  free(d);
+  *dst = buf;
+  *dst_size = pos;
   return 0;
+
+err:
+  free(d);
+  free(buf);
+  return -1;
 }
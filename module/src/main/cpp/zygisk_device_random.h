@@ -1,23 +1,28 @@
 #pragma once
-#include "zygisk.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <random>
+#include <span>
 #include <sstream>
 #include <iomanip>
 #include <string>
 #include <thread>
-#include <android/log.h>
-
-
-static std::mt19937_64 s_rand_engine(std::random_device{}());
+#include "id_format.h"
+#include "oui_table.h"
+#include "rand_engine.h"
 
 // 随机工具函数（生成符合格式的设备标识）
 namespace RandUtil {
+    // 当前线程的随机引擎（每线程一份 xoshiro256**，互不竞争）
+    inline Xoshiro256ss &Engine() { return RandEngine::ThreadLocal(); }
+
     // 生成指定长度十六进制字符串（MAC/Android ID 等）
     inline std::string Hex(int len) {
         std::uniform_int_distribution<int> dist(0, 15);
         std::stringstream ss;
         ss << std::hex << std::setfill('0');
-        for (int i = 0; i < len; i++) ss << std::setw(1) << dist(s_rand_engine);
+        for (int i = 0; i < len; i++) ss << std::setw(1) << dist(Engine());
         return ss.str();
     }
 
@@ -25,7 +30,7 @@ namespace RandUtil {
     inline std::string IMEI() {
         std::uniform_int_distribution<int> dist(0, 9);
         std::string imei;
-        for (int i = 0; i < 14; i++) imei += std::to_string(dist(s_rand_engine));
+        for (int i = 0; i < 14; i++) imei += std::to_string(dist(Engine()));
         // 计算校验位
         int sum = 0;
         for (int i = 0; i < 14; i++) {
@@ -44,8 +49,8 @@ namespace RandUtil {
                                         "183","184","185","186","187","188","189"};
         std::uniform_int_distribution<int> p_dist(0, sizeof(prefixes)/sizeof(prefixes[0])-1);
         std::uniform_int_distribution<int> n_dist(0, 9);
-        std::string mobile = prefixes[p_dist(s_rand_engine)];
-        for (int i = 0; i < 8; i++) mobile += std::to_string(n_dist(s_rand_engine));
+        std::string mobile = prefixes[p_dist(Engine())];
+        for (int i = 0; i < 8; i++) mobile += std::to_string(n_dist(Engine()));
         return mobile;
     }
 
@@ -53,15 +58,15 @@ namespace RandUtil {
     inline std::string SimSerial() {
         std::uniform_int_distribution<int> dist(0, 9);
         std::string serial;
-        for (int i = 0; i < 20; i++) serial += std::to_string(dist(s_rand_engine));
+        for (int i = 0; i < 20; i++) serial += std::to_string(dist(Engine()));
         return serial;
     }
 
-    // 随机 MAC 地址（带分隔符）
+    // 随机 MAC 地址（带分隔符，真实厂商 OUI 前缀，单播且全局唯一）
     inline std::string MAC() {
-        std::string hex = Hex(12);
-        return hex.substr(0,2)+":"+hex.substr(2,2)+":"+hex.substr(4,2)+":"+
-               hex.substr(6,2)+":"+hex.substr(8,2)+":"+hex.substr(10,2);
+        char buf[18];
+        Oui::VendorMac(buf, Engine());
+        return buf;
     }
 
     // 随机 MediaDrm ID（32位十六进制，符合 Widevine 格式）
@@ -71,13 +76,173 @@ namespace RandUtil {
     inline std::string SimOperator() {
         const std::string ops[] = {"46000", "46001", "46003"};
         std::uniform_int_distribution<int> dist(0, 2);
-        return ops[dist(s_rand_engine)];
+        return ops[dist(Engine())];
     }
 
     // 随机 Hardware ID（格式：厂商_随机8位，如 "qcom_abc12345"）
     inline std::string HardwareID() {
         const std::string vendors[] = {"qcom", "mtk", "exynos", "kirin"};
         std::uniform_int_distribution<int> dist(0, 3);
-        return vendors[dist(s_rand_engine)] + "_" + Hex(8);
+        return vendors[dist(Engine())] + "_" + Hex(8);
     }
+
+    // ---------------------------------------------------------------------
+    // 定长缓冲区版本：写入调用方提供的 char 数组，不分配堆内存、不走 iostream。
+    // 所有输出均以 '\0' 结尾，长度在编译期确定。格式由 id_format.h 在编译期描述。
+    // ---------------------------------------------------------------------
+    namespace detail {
+        using IdFormat::detail::CheckEngine;
+        using IdFormat::detail::Bounded;
+        using IdFormat::detail::FillHex;
+
+        inline constexpr const char (&kHexDigits)[17] = IdFormat::detail::kHexLower;
+
+        inline constexpr char kMobilePrefixes[][4] = {
+                "130","131","132","133","134","135","136","137","138","139",
+                "150","151","152","153","155","156","157","158","159",
+                "170","171","173","175","176","177","178","180","181","182",
+                "183","184","185","186","187","188","189"};
+
+        inline constexpr char kSimOperators[][6] = {"46000", "46001", "46003"};
+
+        // 中国运营商 MCC+MNC（IMSI 前缀）
+        inline constexpr char kChinaMccMnc[][6] = {"46000", "46001", "46002", "46003",
+                                                   "46005", "46006", "46007", "46009", "46011"};
+
+        struct Vendor { char name[7]; uint8_t len; };
+        inline constexpr Vendor kHardwareVendors[] = {
+                {"qcom", 4}, {"mtk", 3}, {"exynos", 6}, {"kirin", 5}};
+
+        // 蓝牙设备名默认就是机型名
+        struct Model { char name[21]; uint8_t len; };
+        inline constexpr Model kBluetoothNames[] = {
+                {"Galaxy S21", 10}, {"Galaxy A52", 10}, {"Galaxy Note20 Ultra", 19},
+                {"Redmi Note 9 Pro", 16}, {"Redmi K40", 9}, {"Mi 11", 5},
+                {"vivo X60", 8}, {"OPPO Reno5", 10}, {"OnePlus 9", 9},
+                {"HUAWEI P40", 10}, {"HUAWEI Mate 40 Pro", 18}, {"Pixel 6", 7}};
+    }
+
+    // 各标识的编译期格式（显式限定 IdFormat::，避免与同名生成函数冲突）
+    namespace fmt {
+        using IdFormat::Format;
+        using IdFormat::Digits;
+        using IdFormat::HexUpper;
+        using IdFormat::Alnum;
+        using IdFormat::Lit;
+        using IdFormat::Sep;
+        using IdFormat::OneOf;
+        using IdFormat::Luhn;
+        template <size_t N> using HexLower = IdFormat::Hex<N>;
+
+        using AndroidId    = Format<HexLower<16>>;
+        using Imei         = Format<Digits<14>, Luhn>;
+        using Mobile       = Format<OneOf<detail::kMobilePrefixes>, Digits<8>>;
+        using SimSerial    = Format<Digits<20>>;
+        using Mac          = Format<HexLower<2>, Sep<':'>, HexLower<2>, Sep<':'>, HexLower<2>, Sep<':'>,
+                                    HexLower<2>, Sep<':'>, HexLower<2>, Sep<':'>, HexLower<2>>;
+        using MediaDrmId   = Format<HexLower<32>>;
+        using SimOperator  = Format<OneOf<detail::kSimOperators>>;
+        // ICCID：89（电信行业）+ 86（中国）+ 15 位 + Luhn，共 20 位
+        using Iccid        = Format<Lit<"8986">, Digits<15>, Luhn>;
+        // IMSI：MCC + MNC + 10 位 MSIN，共 15 位
+        using Imsi         = Format<OneOf<detail::kChinaMccMnc>, Digits<10>>;
+        // 蓝牙地址（Settings.Secure bluetooth_address 使用大写）
+        using BluetoothMac = Format<HexUpper<2>, Sep<':'>, HexUpper<2>, Sep<':'>, HexUpper<2>, Sep<':'>,
+                                    HexUpper<2>, Sep<':'>, HexUpper<2>, Sep<':'>, HexUpper<2>>;
+        // ro.serialno 风格序列号
+        using Serial       = Format<Alnum<12>>;
+    }
+
+    inline constexpr size_t kHexIdLen      = fmt::AndroidId::kLen;
+    inline constexpr size_t kImeiLen       = fmt::Imei::kLen;
+    inline constexpr size_t kMobileLen     = fmt::Mobile::kLen;
+    inline constexpr size_t kSimSerialLen  = fmt::SimSerial::kLen;
+    inline constexpr size_t kMacLen        = fmt::Mac::kLen;
+    inline constexpr size_t kMediaDrmIdLen = fmt::MediaDrmId::kLen;
+    inline constexpr size_t kSimOperatorLen = fmt::SimOperator::kLen;
+    inline constexpr size_t kIccidLen      = fmt::Iccid::kLen;
+    inline constexpr size_t kImsiLen       = fmt::Imsi::kLen;
+    inline constexpr size_t kBluetoothMacLen = fmt::BluetoothMac::kLen;
+    inline constexpr size_t kSerialLen     = fmt::Serial::kLen;
+    inline constexpr size_t kHardwareIdMaxLen = 15; // "exynos_" + 8 位十六进制
+    inline constexpr size_t kBluetoothNameMaxLen = sizeof(detail::Model::name) - 1;
+
+    static_assert(kHexIdLen == 16 && kImeiLen == 15 && kMobileLen == 11 && kSimSerialLen == 20);
+    static_assert(kMacLen == 17 && kMediaDrmIdLen == 32 && kSimOperatorLen == 5);
+    static_assert(kIccidLen == 20 && kImsiLen == 15 && kBluetoothMacLen == 17);
+
+    // 容纳长度为 N 的标识及结尾 '\0'
+    template <size_t N> using IdBuf = std::array<char, N + 1>;
+
+    template <typename Rng>
+    inline void Hex(std::span<char, kHexIdLen + 1> out, Rng &rng) { fmt::AndroidId::Generate(out, rng); }
+
+    template <typename Rng>
+    inline void IMEI(std::span<char, kImeiLen + 1> out, Rng &rng) { fmt::Imei::Generate(out, rng); }
+
+    template <typename Rng>
+    inline void Mobile(std::span<char, kMobileLen + 1> out, Rng &rng) { fmt::Mobile::Generate(out, rng); }
+
+    template <typename Rng>
+    inline void SimSerial(std::span<char, kSimSerialLen + 1> out, Rng &rng) { fmt::SimSerial::Generate(out, rng); }
+
+    // MAC 前 24 位取自内嵌 OUI 表（见 oui_table.h），格式同 fmt::Mac
+    template <typename Rng>
+    inline void MAC(std::span<char, kMacLen + 1> out, Rng &rng) { Oui::VendorMac(out, rng); }
+
+    template <typename Rng>
+    inline void MediaDrmID(std::span<char, kMediaDrmIdLen + 1> out, Rng &rng) { fmt::MediaDrmId::Generate(out, rng); }
+
+    template <typename Rng>
+    inline void SimOperator(std::span<char, kSimOperatorLen + 1> out, Rng &rng) { fmt::SimOperator::Generate(out, rng); }
+
+    template <typename Rng>
+    inline void ICCID(std::span<char, kIccidLen + 1> out, Rng &rng) { fmt::Iccid::Generate(out, rng); }
+
+    template <typename Rng>
+    inline void IMSI(std::span<char, kImsiLen + 1> out, Rng &rng) { fmt::Imsi::Generate(out, rng); }
+
+    template <typename Rng>
+    inline void BluetoothMAC(std::span<char, kBluetoothMacLen + 1> out, Rng &rng) { Oui::VendorMac(out, rng, true); }
+
+    template <typename Rng>
+    inline void Serial(std::span<char, kSerialLen + 1> out, Rng &rng) { fmt::Serial::Generate(out, rng); }
+
+    // 厂商名长度不一，无法用定长格式描述，单独实现；返回写入长度（不含 '\0'）
+    template <typename Rng>
+    inline size_t HardwareID(std::span<char, kHardwareIdMaxLen + 1> out, Rng &rng) {
+        detail::CheckEngine<Rng>();
+        constexpr uint32_t n = std::size(detail::kHardwareVendors);
+        const detail::Vendor &v = detail::kHardwareVendors[detail::Bounded(n, rng)];
+        for (size_t i = 0; i < v.len; i++) out[i] = v.name[i];
+        out[v.len] = '_';
+        detail::FillHex(out.data() + v.len + 1, 8, detail::kHexDigits, rng);
+        size_t len = v.len + 1 + 8;
+        out[len] = '\0';
+        return len;
+    }
+
+    // 返回写入长度（不含 '\0'）
+    template <typename Rng>
+    inline size_t BluetoothName(std::span<char, kBluetoothNameMaxLen + 1> out, Rng &rng) {
+        detail::CheckEngine<Rng>();
+        constexpr uint32_t n = std::size(detail::kBluetoothNames);
+        const detail::Model &m = detail::kBluetoothNames[detail::Bounded(n, rng)];
+        for (size_t i = 0; i <= m.len; i++) out[i] = m.name[i];
+        return m.len;
+    }
+
+    // 使用当前线程随机引擎的便捷重载
+    inline void Hex(std::span<char, kHexIdLen + 1> out) { Hex(out, Engine()); }
+    inline void IMEI(std::span<char, kImeiLen + 1> out) { IMEI(out, Engine()); }
+    inline void Mobile(std::span<char, kMobileLen + 1> out) { Mobile(out, Engine()); }
+    inline void SimSerial(std::span<char, kSimSerialLen + 1> out) { SimSerial(out, Engine()); }
+    inline void MAC(std::span<char, kMacLen + 1> out) { MAC(out, Engine()); }
+    inline void MediaDrmID(std::span<char, kMediaDrmIdLen + 1> out) { MediaDrmID(out, Engine()); }
+    inline void SimOperator(std::span<char, kSimOperatorLen + 1> out) { SimOperator(out, Engine()); }
+    inline void ICCID(std::span<char, kIccidLen + 1> out) { ICCID(out, Engine()); }
+    inline void IMSI(std::span<char, kImsiLen + 1> out) { IMSI(out, Engine()); }
+    inline void BluetoothMAC(std::span<char, kBluetoothMacLen + 1> out) { BluetoothMAC(out, Engine()); }
+    inline void Serial(std::span<char, kSerialLen + 1> out) { Serial(out, Engine()); }
+    inline size_t HardwareID(std::span<char, kHardwareIdMaxLen + 1> out) { return HardwareID(out, Engine()); }
 }